@@ -18,6 +18,7 @@
 #define GPIO_MAX_PINS                   (112)
 #define GPIO_CN_DESCRIPTOR(port)        ((GPIO_ChangeNoticeDescriptor)&CNCON)
 #define GPIO_MAX_CN_PINS                (19)
+#define GPIO_NUMBER_OF_PORTS            (7)
 /*********************************************************************
 * Module Preprocessor Macros
 **********************************************************************/
@@ -26,6 +27,14 @@
 /**********************************************************************
 * Module Typedefs
 **********************************************************************/
+/*Per port masks a pin table is folded into*/
+typedef struct{
+    uint16_t    used;
+    uint16_t    analog;
+    uint16_t    output;
+    uint16_t    high;
+    uint16_t    openDrain;
+}GPIO_PortConfig;
 
 /**********************************************************************
 * Module Variable Definitions
@@ -50,9 +59,13 @@ GPIO_PIN_MAP(GPIO_PORT_D, GPIO_PIN_7),
 GPIO_PIN_MAP(GPIO_PORT_F, GPIO_PIN_4),
 GPIO_PIN_MAP(GPIO_PORT_F, GPIO_PIN_5),
 };
+static GPIO_CALLBACK_OBJECT gpioCallbacks[GPIO_NUMBER_OF_PORTS][GPIO_CALLBACKS_PER_PORT];
+static uint32_t gpioCallbackCounts[GPIO_NUMBER_OF_PORTS];
+static uint32_t gpioPortValues[GPIO_NUMBER_OF_PORTS];
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
+static uint32_t GPIO_cn_port_mask(GPIO_Port port);
 
 /**********************************************************************
 * Function Definitions
@@ -60,6 +73,8 @@ GPIO_PIN_MAP(GPIO_PORT_F, GPIO_PIN_5),
 void    GPIO_pin_initialize             (GPIO_PinMap pin, int flags)
 {
     if(flags & GPIO_OUTPUT){
+        if(flags & GPIO_INIT_HIGH)
+            GPIO_PORT(pin>>GPIO_PORT_SHIFT)->lat.set = GPIO_PIN(pin);
         GPIO_PORT(pin>>GPIO_PORT_SHIFT)->tris.clr = GPIO_PIN(pin);
         if(flags & GPIO_OPENDRAIN)
             GPIO_PORT(pin>>GPIO_PORT_SHIFT)->odc.set = GPIO_PIN(pin);
@@ -128,7 +143,14 @@ void    GPIO_pin_toggle            (GPIO_PinMap pin)
 
 void GPIO_port_write(GPIO_Port port, uint32_t value, uint32_t mask)
 {
-    GPIO_PORT(port)->lat.reg = value & mask;
+    /*Pins outside the mask are never touched, each pin changes at most once*/
+    GPIO_PORT(port)->lat.clr = ~value & mask;
+    GPIO_PORT(port)->lat.set = value & mask;
+}
+void    GPIO_port_modify                (GPIO_Port port, uint32_t setMask, uint32_t clrMask)
+{
+    GPIO_PORT(port)->lat.clr = clrMask & ~setMask;
+    GPIO_PORT(port)->lat.set = setMask;
 }
 uint32_t    GPIO_port_read                  (GPIO_Port port, uint32_t mask)
 {
@@ -139,19 +161,155 @@ void    GPIO_port_toggle                (GPIO_Port port, uint32_t mask)
     GPIO_PORT(port)->lat.inv = mask;
 }
 
+int     GPIO_group_initialize           (GPIO_Group *group, const GPIO_PinMap *pins, size_t count, int flags)
+{
+    if(count > GPIO_GROUP_MAX_PINS)
+        return -1;
+
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++)
+        group->masks[p] = 0;
+    for(size_t i = 0; i < count; i++){
+        group->pins[i] = pins[i];
+        group->masks[pins[i] >> GPIO_PORT_SHIFT] |= GPIO_PIN(pins[i]);
+        GPIO_pin_initialize(pins[i], flags);
+    }
+    group->count = count;
+    return 0;
+}
+void    GPIO_group_set                  (const GPIO_Group *group)
+{
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            GPIO_PORT(p)->lat.set = group->masks[p];
+    }
+}
+void    GPIO_group_clear                (const GPIO_Group *group)
+{
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            GPIO_PORT(p)->lat.clr = group->masks[p];
+    }
+}
+void    GPIO_group_toggle               (const GPIO_Group *group)
+{
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            GPIO_PORT(p)->lat.inv = group->masks[p];
+    }
+}
+void    GPIO_group_write                (const GPIO_Group *group, uint32_t value)
+{
+    uint16_t setMasks[GPIO_GROUP_MAX_PORTS] = {0};
+
+    /*Bit i of value drives the i-th pin of the group*/
+    for(uint32_t i = 0; i < group->count; i++){
+        if(value & (1u << i))
+            setMasks[group->pins[i] >> GPIO_PORT_SHIFT] |= GPIO_PIN(group->pins[i]);
+    }
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            GPIO_port_modify(p, setMasks[p], group->masks[p]);
+    }
+}
+uint32_t GPIO_group_read                (const GPIO_Group *group)
+{
+    uint32_t ports[GPIO_GROUP_MAX_PORTS] = {0};
+    uint32_t value = 0;
+
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            ports[p] = GPIO_PORT(p)->port.reg;
+    }
+    for(uint32_t i = 0; i < group->count; i++){
+        if(ports[group->pins[i] >> GPIO_PORT_SHIFT] & GPIO_PIN(group->pins[i]))
+            value |= 1u << i;
+    }
+    return value;
+}
+
 void    GPIO_pin_interrupt_set     (GPIO_PinMap pin, bool state)
 {
     for (int i=0;i<GPIO_MAX_CN_PINS;i++){
         if(cnen_map[i] == pin){
-            if(state)
-                GPIO_CN_DESCRIPTOR(0)->cnpue.set = 1<<i;
+            if(state){
+                GPIO_CN_DESCRIPTOR(0)->cnen.set = 1<<i;
+                GPIO_CN_DESCRIPTOR(0)->cncon.set = _CNCON_ON_MASK;
+            }
             else
-                GPIO_CN_DESCRIPTOR(0)->cnpue.clr = 1<<i;
+                GPIO_CN_DESCRIPTOR(0)->cnen.clr = 1<<i;
             break;
         }
     }
 }
 
+void    GPIO_pin_table_apply            (const GPIO_PinConfig *table, size_t count)
+{
+    GPIO_PortConfig ports[GPIO_NUMBER_OF_PORTS] = {0};
+    uint32_t cnUsed = 0, cnPullUp = 0, cnIrq = 0;
+
+    /*No PPS on this part, slew rate and pull-downs do not exist either*/
+    for(size_t i = 0; i < count; i++){
+        GPIO_PortConfig *cfg = &ports[table[i].pin >> GPIO_PORT_SHIFT];
+        uint32_t flags = table[i].flags;
+        uint32_t mask = GPIO_PIN(table[i].pin);
+        uint32_t cn = 0;
+
+        for(int c = 0; c < GPIO_MAX_CN_PINS; c++){
+            if(cnen_map[c] == table[i].pin){
+                cn = 1u << c;
+                break;
+            }
+        }
+        cfg->used |= mask;
+        cnUsed |= cn;
+        if(flags & GPIO_ANALOG){
+            cfg->analog |= mask;
+            continue;
+        }
+        if(flags & GPIO_OUTPUT){
+            cfg->output |= mask;
+            if(flags & GPIO_INIT_HIGH)
+                cfg->high |= mask;
+            if(flags & GPIO_OPENDRAIN)
+                cfg->openDrain |= mask;
+            continue;
+        }
+        if(flags & GPIO_PULLUP)
+            cnPullUp |= cn;
+        if(flags & GPIO_IRQ)
+            cnIrq |= cn;
+    }
+
+    /*Change notice pull-ups and enables are one register for all ports*/
+    if(cnUsed){
+        GPIO_CN_DESCRIPTOR(0)->cnpue.set = cnPullUp;
+        GPIO_CN_DESCRIPTOR(0)->cnpue.clr = cnUsed & ~cnPullUp;
+        GPIO_CN_DESCRIPTOR(0)->cnen.set = cnIrq;
+        GPIO_CN_DESCRIPTOR(0)->cnen.clr = cnUsed & ~cnIrq;
+        if(cnIrq)
+            GPIO_CN_DESCRIPTOR(0)->cncon.set = _CNCON_ON_MASK;
+    }
+    /*Only PORTB has analog inputs, AD1PCFG bits are set for digital*/
+    if(ports[GPIO_PORT_B].used){
+        AD1PCFGCLR = ports[GPIO_PORT_B].analog;
+        AD1PCFGSET = ports[GPIO_PORT_B].used & ~ports[GPIO_PORT_B].analog;
+    }
+
+    for(GPIO_Port port = GPIO_PORT_B; port < GPIO_NUMBER_OF_PORTS; port++){
+        GPIO_PortConfig *cfg = &ports[port];
+
+        if(cfg->used == 0)
+            continue;
+        GPIO_PORT(port)->lat.set = cfg->high;
+        GPIO_PORT(port)->lat.clr = cfg->output & ~cfg->high;
+        GPIO_PORT(port)->odc.set = cfg->openDrain;
+        GPIO_PORT(port)->odc.clr = cfg->used & ~cfg->openDrain;
+        /*Direction last so no pin drives a stale level or floats while pulls are still off*/
+        GPIO_PORT(port)->tris.set = cfg->used & ~cfg->output;
+        GPIO_PORT(port)->tris.clr = cfg->output;
+    }
+}
+
 HAL_WEAK_FUNCTION void    GPIO_pin_interrupt_callback     (GPIO_PinMap pin)
 {
     (void)pin;
@@ -159,6 +317,86 @@ HAL_WEAK_FUNCTION void    GPIO_pin_interrupt_callback     (GPIO_PinMap pin)
 
 void GPIO_interrupt_handler(GPIO_Port port)
 {
+    uint32_t status[GPIO_NUMBER_OF_PORTS];
+    uint32_t value;
+    GPIO_Port p;
+
+    /*There is a single change notice vector, every port with a registered callback is
+     compared against its last value to find out which pins changed. Reading the ports
+     also clears the mismatch condition.*/
+    for(p = GPIO_PORT_B; p < GPIO_NUMBER_OF_PORTS; p++){
+        status[p] = 0;
+        if(gpioCallbackCounts[p] == 0)
+            continue;
+        value = GPIO_PORT(p)->port.reg;
+        status[p] = (value ^ gpioPortValues[p]) & GPIO_cn_port_mask(p);
+        gpioPortValues[p] = value;
+    }
+
     EVIC_channel_pending_clear(GPIO_PORT_IRQ_CHANNEL(port));
+
+    for(p = GPIO_PORT_B; p < GPIO_NUMBER_OF_PORTS; p++){
+        if(status[p] == 0)
+            continue;
+        for(int i = 0; i < GPIO_CALLBACKS_PER_PORT; i++){
+            GPIO_CALLBACK_OBJECT *obj = &gpioCallbacks[p][i];
+            if(obj->callback != NULL)
+                obj->callback(status[p] | obj->pin, obj->context);
+        }
+    }
     GPIO_pin_interrupt_callback( 0 );
 }
+
+int GPIO_callback_register(GPIO_Port port, GPIO_Callback callback, uintptr_t context)
+{
+    GPIO_CALLBACK_OBJECT *slot = NULL;
+
+    uint32_t status = EVIC_disable_interrupts();
+    for(int i = 0; i < GPIO_CALLBACKS_PER_PORT; i++){
+        GPIO_CALLBACK_OBJECT *obj = &gpioCallbacks[port][i];
+        if(obj->callback == callback && obj->context == context){
+            EVIC_restore_interrupts(status);
+            return 0;
+        }
+        if(obj->callback == NULL && slot == NULL)
+            slot = obj;
+    }
+    if(slot != NULL){
+        if(gpioCallbackCounts[port]++ == 0)
+            gpioPortValues[port] = GPIO_PORT(port)->port.reg;
+        slot->pin = port << GPIO_PORT_SHIFT;
+        slot->context = context;
+        slot->callback = callback;
+    }
+    EVIC_restore_interrupts(status);
+    return slot != NULL ? 0 : -1;
+}
+
+void GPIO_callback_unregister(GPIO_Port port, GPIO_Callback callback, uintptr_t context)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    for(int i = 0; i < GPIO_CALLBACKS_PER_PORT; i++){
+        GPIO_CALLBACK_OBJECT *obj = &gpioCallbacks[port][i];
+        if(obj->callback == callback && obj->context == context){
+            obj->callback = NULL;
+            gpioCallbackCounts[port]--;
+        }
+    }
+    EVIC_restore_interrupts(status);
+}
+
+static uint32_t GPIO_cn_port_mask(GPIO_Port port)
+{
+    uint32_t mask = 0;
+    uint32_t cnen = GPIO_CN_DESCRIPTOR(0)->cnen.reg;
+    for (int i=0;i<GPIO_MAX_CN_PINS;i++){
+        if((cnen & (1<<i)) && (cnen_map[i] >> GPIO_PORT_SHIFT) == port)
+            mask |= GPIO_PIN(cnen_map[i]);
+    }
+    return mask;
+}
+
+GPIO_Descriptor GPIO_get_descriptor(GPIO_Port port)
+{
+    return GPIO_PORT(port);
+}
@@ -0,0 +1,69 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_family.h"
+#include "uart.h"
+#include "spi.h"
+#include "i2c.h"
+/**********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+const EVIC_CHANNEL halTmrIrqChannels[TMR_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_TIMER_2,
+        EVIC_CHANNEL_TIMER_3,
+        EVIC_CHANNEL_TIMER_4,
+        EVIC_CHANNEL_TIMER_5,
+};
+const EVIC_CHANNEL halOcIrqChannels[OC_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_OUTPUT_COMPARE_1,
+        EVIC_CHANNEL_OUTPUT_COMPARE_2,
+        EVIC_CHANNEL_OUTPUT_COMPARE_3,
+        EVIC_CHANNEL_OUTPUT_COMPARE_4,
+        EVIC_CHANNEL_OUTPUT_COMPARE_5,
+};
+const EVIC_CHANNEL halIcIrqChannels[IC_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_INPUT_CAPTURE_1,
+        EVIC_CHANNEL_INPUT_CAPTURE_2,
+        EVIC_CHANNEL_INPUT_CAPTURE_3,
+        EVIC_CHANNEL_INPUT_CAPTURE_4,
+        EVIC_CHANNEL_INPUT_CAPTURE_5,
+};
+const EVIC_CHANNEL halUartIrqBase[UART_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_UART1_ERR,
+        EVIC_CHANNEL_UART2_ERR,
+        EVIC_CHANNEL_UART3_ERR,
+        EVIC_CHANNEL_UART4_ERR,
+        EVIC_CHANNEL_UART5_ERR,
+        EVIC_CHANNEL_UART6_ERR,
+};
+const EVIC_CHANNEL halSpiIrqBase[SPI_NUMBER_OF_CHANNELS]={
+        [SPI_CHANNEL_2] = EVIC_CHANNEL_SPI2_ERR,
+        [SPI_CHANNEL_3] = EVIC_CHANNEL_SPI3_ERR,
+        [SPI_CHANNEL_4] = EVIC_CHANNEL_SPI4_ERR,
+};
+const EVIC_CHANNEL halI2cIrqBase[I2C_NUMBER_OF_CHANNELS]={
+        [I2C_CHANNEL_1] = EVIC_CHANNEL_I2C1_BUS,
+        [I2C_CHANNEL_3] = EVIC_CHANNEL_I2C3_BUS,
+        [I2C_CHANNEL_4] = EVIC_CHANNEL_I2C4_BUS,
+        [I2C_CHANNEL_5] = EVIC_CHANNEL_I2C5_BUS,
+};
+const UART_Descriptor halUartDescriptors[UART_NUMBER_OF_CHANNELS]={
+        [UART_CHANNEL_1] = (UART_Descriptor)&U1MODE,
+        [UART_CHANNEL_2] = (UART_Descriptor)&U2MODE,
+        [UART_CHANNEL_3] = (UART_Descriptor)&U3MODE,
+        [UART_CHANNEL_4] = (UART_Descriptor)&U4MODE,
+        [UART_CHANNEL_5] = (UART_Descriptor)&U5MODE,
+        [UART_CHANNEL_6] = (UART_Descriptor)&U6MODE,
+};
+const SPI_Descriptor halSpiDescriptors[SPI_NUMBER_OF_CHANNELS]={
+        [SPI_CHANNEL_2] = (SPI_Descriptor)&SPI2CON,
+        [SPI_CHANNEL_3] = (SPI_Descriptor)&SPI3CON,
+        [SPI_CHANNEL_4] = (SPI_Descriptor)&SPI4CON,
+};
+const I2C_Descriptor halI2cDescriptors[I2C_NUMBER_OF_CHANNELS]={
+        [I2C_CHANNEL_1] = (I2C_Descriptor)&I2C1CON,
+        [I2C_CHANNEL_3] = (I2C_Descriptor)&I2C3CON,
+        [I2C_CHANNEL_4] = (I2C_Descriptor)&I2C4CON,
+        [I2C_CHANNEL_5] = (I2C_Descriptor)&I2C5CON,
+};
@@ -0,0 +1,74 @@
+/**
+ * @file hal_family.h
+ * @brief PIC32MX795F512H family layer. Channel counts, register descriptor lookups and interrupt maps for the drivers
+ * in common/, which are built unchanged for every family.
+ */
+
+#ifndef HAL_FAMILY_H
+#define HAL_FAMILY_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "pic32mx_registers.h"
+#include "evic.h"
+#include <xc.h>
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+/*RX, TX and fault sources of a UART or SPI share one vector, the handlers check every flag*/
+#define HAL_SHARED_PERIPHERAL_VECTORS       (1)
+/*DCHxSSIZ, DCHxDSIZ and DCHxCSIZ are 8 bit*/
+#define DMA_MAX_TRANSFER_SIZE               (255)
+
+#define DMA_NUMBER_OF_CHANNELS              (8)
+#define TMR_NUMBER_OF_CHANNELS              (4)
+#define OC_NUMBER_OF_CHANNELS               (5)
+#define IC_NUMBER_OF_CHANNELS               (5)
+#define UART_NUMBER_OF_CHANNELS             (6)
+/*Channels are indexed by SPI_CHANNEL_x up to SPI_CHANNEL_4, SPI1 does not exist on this part*/
+#define SPI_NUMBER_OF_CHANNELS              (4)
+/*Channels are indexed by I2C_CHANNEL_x, I2C2 does not exist on this part*/
+#define I2C_NUMBER_OF_CHANNELS              (5)
+/**********************************************************************
+* Preprocessor Macros
+**********************************************************************/
+#define DMA_DESCRIPTOR(channel)             ((DMA_Descriptor)(((uint8_t*)(&DCH0CON)) + 0xC0*(channel)))
+#define TMR_DESCRIPTOR(channel)             ((TMR_Descriptor)(((uint8_t*)(_TMR2_BASE_ADDRESS)) + 0x200*(channel)))
+#define OC_DESCRIPTOR(channel)              ((OC_Descriptor)(((uint8_t*)(_OCMP1_BASE_ADDRESS)) + 0x200*(channel)))
+#define IC_DESCRIPTOR(channel)              ((IC_Descriptor)(((uint8_t*)(_ICAP1_BASE_ADDRESS)) + 0x200*(channel)))
+/*UART, SPI and I2C instances are not evenly spaced*/
+#define UART_DESCRIPTOR(channel)            (halUartDescriptors[channel])
+#define SPI_DESCRIPTOR(channel)             (halSpiDescriptors[channel])
+#define I2C_DESCRIPTOR(channel)             (halI2cDescriptors[channel])
+#define I2C_CHANNEL_PRESENT(channel)        ((channel) < I2C_NUMBER_OF_CHANNELS && halI2cDescriptors[channel] != NULL)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+/**********************************************************************
+* Variable Declarations
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+extern const EVIC_CHANNEL halTmrIrqChannels[TMR_NUMBER_OF_CHANNELS];
+extern const EVIC_CHANNEL halOcIrqChannels[OC_NUMBER_OF_CHANNELS];
+extern const EVIC_CHANNEL halIcIrqChannels[IC_NUMBER_OF_CHANNELS];
+/*Fault (error) interrupt of each channel, RX and TX are the next two*/
+extern const EVIC_CHANNEL halUartIrqBase[UART_NUMBER_OF_CHANNELS];
+extern const EVIC_CHANNEL halSpiIrqBase[SPI_NUMBER_OF_CHANNELS];
+/*Bus collision interrupt of each channel, slave and master are the next two*/
+extern const EVIC_CHANNEL halI2cIrqBase[I2C_NUMBER_OF_CHANNELS];
+extern const UART_Descriptor halUartDescriptors[UART_NUMBER_OF_CHANNELS];
+extern const SPI_Descriptor halSpiDescriptors[SPI_NUMBER_OF_CHANNELS];
+extern const I2C_Descriptor halI2cDescriptors[I2C_NUMBER_OF_CHANNELS];
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //HAL_FAMILY_H
@@ -0,0 +1,62 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "perf.h"
+#include <xc.h>
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+/*The core timer runs at SYSCLK/2*/
+#define PERF_CYCLES()                       (_CP0_GET_COUNT() << 1)
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+/*The M4K core has no performance counters*/
+bool            SYS_perf_available      (void)
+{
+    return false;
+}
+
+int             SYS_perf_counter_set    (uint32_t counter, uint32_t event)
+{
+    return event == SYS_PERF_NONE ? 0 : -1;
+}
+
+uint32_t        SYS_perf_counter_get    (uint32_t counter)
+{
+    return 0;
+}
+
+uint32_t        SYS_perf_cycles_get     (void)
+{
+    return PERF_CYCLES();
+}
+
+uint32_t        SYS_perf_counter_event_get(uint32_t counter)
+{
+    return SYS_PERF_NONE;
+}
+
+void            SYS_perf_sample         (SYS_Perf_Sample *sample)
+{
+    sample->events[SYS_PERF_COUNTER_0] = 0;
+    sample->events[SYS_PERF_COUNTER_1] = 0;
+    sample->cycles = PERF_CYCLES();
+}
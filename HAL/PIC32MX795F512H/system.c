@@ -4,10 +4,24 @@
 #include "system.h"
 #include <xc.h>
 #include "pic32mx_registers.h"
+#include "evic.h"
+#include "hal_delay.h"
+#include "hal_time.h"
+#include "dma.h"
 /**********************************************************************
 * Module Preprocessor Constants
 **********************************************************************/
 #define SYS_PBCLK_BASE                          ((uint8_t*)&PB1DIV)
+#ifndef SYS_POSC_FREQUENCY
+#define SYS_POSC_FREQUENCY                      (8000000UL)
+#endif
+#define SYS_FRC_FREQUENCY                       (8000000UL)
+#define SYS_CLOCK_MAX_FREQUENCY                 (80000000UL)
+#define SYS_PLL_INPUT_MIN                       (4000000UL)
+#define SYS_PLL_INPUT_MAX                       (5000000UL)
+#define SYS_OSC_FRC                             (0)
+#define SYS_OSC_FRCPLL                          (1)
+#define SYS_OSC_POSCPLL                         (3)
 /**********************************************************************
 * Module Preprocessor Macros
 **********************************************************************/
@@ -15,14 +29,30 @@
 /**********************************************************************
 * Module Typedefs
 **********************************************************************/
-
+typedef struct{
+    SYS_Clock_Notifier  notifier;
+    uintptr_t           context;
+}SYS_Clock_Listener;
 /*********************************************************************
 * Module Variable Definitions
 **********************************************************************/
-
+static uint32_t sysClockFrequency = HAL_SYSTEM_CLOCK;
+static SYS_Clock_Listener sysClockListeners[SYS_CLOCK_MAX_NOTIFIERS];
+/*FPLLIDIV is a configuration bit, only PLLMULT and PLLODIV can change at run time*/
+static const uint8_t pllIdivTable[] = { 1, 2, 3, 4, 5, 6, 10, 12 };
+static const uint8_t pllMultTable[] = { 15, 16, 17, 18, 19, 20, 21, 24 };
+static const uint16_t pllOdivTable[] = { 1, 2, 4, 8, 16, 32, 64, 256 };
+static uint8_t pmdCounts[SYS_PMD_NUMBER_OF_MODULES];
+static uint32_t powerInhibit[SYS_POWER_MODES];
+static SYS_Power_Stats powerStats;
+static uint64_t powerStatsStart;
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
+static void SYS_oscillator_switch(uint32_t source);
+static uint32_t SYS_flash_wait_states(uint32_t frequency);
+static void SYS_pmd_power(uint32_t module, bool on);
+static uint32_t SYS_power_enter(uint32_t mode);
 
 /**********************************************************************
 * Function Definitions
@@ -34,7 +64,7 @@ void SYS_initialize()
     __builtin_mtc0(16, 0,(__builtin_mfc0(16, 0) | 0x3));
 
     /* Configure Flash Wait States and Prefetch */
-    CHECONbits.PFMWS = 2;
+    SYS_flash_wait_states_update();
     CHECONbits.PREFEN = 3;
 
     BMXCONbits.BMXWSDRM = 0;
@@ -78,7 +108,7 @@ void SYS_peripheral_clock_config(uint32_t clockChannel, uint32_t flags)
 
 uint32_t    SYS_peripheral_clock_frequency_get(uint32_t clockChannel)
 {
-    return HAL_SYSTEM_CLOCK / (1 << ((OSCCON & _OSCCON_PBDIV_MASK) >> _OSCCON_PBDIV_POSITION));
+    return sysClockFrequency / (1 << ((OSCCON & _OSCCON_PBDIV_MASK) >> _OSCCON_PBDIV_POSITION));
 }
 
 void SYS_soft_reset(uint32_t val)
@@ -97,4 +127,234 @@ void SYS_soft_reset(uint32_t val)
     (void)dummy;
 /* prevent any unwanted code execution until reset occurs*/
     while(1);
-}
\ No newline at end of file
+}
+
+uint32_t    SYS_clock_frequency_get(void)
+{
+    return sysClockFrequency;
+}
+
+/*Reprograms the PLL for the closest achievable frequency and returns it, 0 when nothing fits.
+ The PLL can only be reconfigured while it is not the clock source, the core runs from FRC meanwhile.*/
+uint32_t    SYS_clock_set(uint32_t frequency)
+{
+    uint32_t source = OSCCONbits.COSC == SYS_OSC_FRCPLL ? SYS_OSC_FRCPLL : SYS_OSC_POSCPLL;
+    uint32_t input = source == SYS_OSC_FRCPLL ? SYS_FRC_FREQUENCY : SYS_POSC_FREQUENCY;
+    uint32_t pllIn = input / pllIdivTable[DEVCFG2bits.FPLLIDIV];
+    uint32_t best = 0, bestError = UINT32_MAX;
+    uint32_t bestMult = 0, bestOdiv = 0;
+
+    if(frequency == 0 || frequency > SYS_CLOCK_MAX_FREQUENCY || pllIn < SYS_PLL_INPUT_MIN || pllIn > SYS_PLL_INPUT_MAX)
+        return 0;
+
+    for(uint32_t m = 0; m < sizeof(pllMultTable); m++){
+        for(uint32_t o = 0; o < sizeof(pllOdivTable) / sizeof(pllOdivTable[0]); o++){
+            uint32_t achieved = pllIn * pllMultTable[m] / pllOdivTable[o];
+            uint32_t error = achieved > frequency ? achieved - frequency : frequency - achieved;
+            if(achieved <= SYS_CLOCK_MAX_FREQUENCY && error < bestError){
+                best = achieved;
+                bestError = error;
+                bestMult = m;
+                bestOdiv = o;
+            }
+        }
+    }
+    if(best == 0)
+        return 0;
+
+    uint32_t status = EVIC_disable_interrupts();
+    uint32_t old = sysClockFrequency;
+
+    /*Flash needs the extra wait states before the clock goes up and keeps them until it is down*/
+    if(best > old)
+        CHECONbits.PFMWS = SYS_flash_wait_states(best);
+
+    SYS_oscillator_switch(SYS_OSC_FRC);
+    SYSKEY = 0x00000000;
+    SYSKEY = 0xAA996655;
+    SYSKEY = 0x556699AA;
+    OSCCONbits.PLLMULT = bestMult;
+    OSCCONbits.PLLODIV = bestOdiv;
+    SYSKEY = 0x00000000;
+    SYS_oscillator_switch(source);
+
+    if(best < old)
+        CHECONbits.PFMWS = SYS_flash_wait_states(best);
+
+    sysClockFrequency = best;
+    HAL_delay_clock_update(best);
+    for(uint32_t i = 0; i < SYS_CLOCK_MAX_NOTIFIERS; i++){
+        if(sysClockListeners[i].notifier != NULL)
+            sysClockListeners[i].notifier(old, best, sysClockListeners[i].context);
+    }
+    EVIC_restore_interrupts(status);
+    return best;
+}
+
+/*Fewest flash wait states that are safe at the current SYSCLK*/
+void        SYS_flash_wait_states_update(void)
+{
+    CHECONbits.PFMWS = SYS_flash_wait_states(sysClockFrequency);
+}
+
+bool        SYS_clock_notifier_register(SYS_Clock_Notifier notifier, uintptr_t context)
+{
+    for(uint32_t i = 0; i < SYS_CLOCK_MAX_NOTIFIERS; i++){
+        if(sysClockListeners[i].notifier == NULL){
+            sysClockListeners[i].context = context;
+            sysClockListeners[i].notifier = notifier;
+            return true;
+        }
+    }
+    return false;
+}
+
+void        SYS_clock_notifier_unregister(SYS_Clock_Notifier notifier, uintptr_t context)
+{
+    for(uint32_t i = 0; i < SYS_CLOCK_MAX_NOTIFIERS; i++){
+        if(sysClockListeners[i].notifier == notifier && sysClockListeners[i].context == context)
+            sysClockListeners[i].notifier = NULL;
+    }
+}
+
+void        SYS_pmd_acquire(uint32_t module)
+{
+    if(module >= SYS_PMD_NUMBER_OF_MODULES)
+        return;
+    uint32_t status = EVIC_disable_interrupts();
+    if(pmdCounts[module]++ == 0)
+        SYS_pmd_power(module, true);
+    EVIC_restore_interrupts(status);
+}
+
+void        SYS_pmd_release(uint32_t module)
+{
+    if(module >= SYS_PMD_NUMBER_OF_MODULES)
+        return;
+    uint32_t status = EVIC_disable_interrupts();
+    if(pmdCounts[module] != 0 && --pmdCounts[module] == 0)
+        SYS_pmd_power(module, false);
+    EVIC_restore_interrupts(status);
+}
+
+uint32_t    SYS_pmd_count_get(uint32_t module)
+{
+    if(module >= SYS_PMD_NUMBER_OF_MODULES)
+        return 0;
+    return pmdCounts[module];
+}
+
+uint32_t    SYS_idle(void)
+{
+    return SYS_power_enter(SYS_POWER_IDLE);
+}
+
+uint32_t    SYS_sleep(void)
+{
+    return SYS_power_enter(DMA_is_active() ? SYS_POWER_IDLE : SYS_POWER_SLEEP);
+}
+
+void        SYS_power_inhibit(uint32_t mode)
+{
+    if(mode == SYS_POWER_RUN || mode >= SYS_POWER_MODES)
+        return;
+    uint32_t status = EVIC_disable_interrupts();
+    powerInhibit[mode]++;
+    EVIC_restore_interrupts(status);
+}
+
+void        SYS_power_allow(uint32_t mode)
+{
+    if(mode == SYS_POWER_RUN || mode >= SYS_POWER_MODES)
+        return;
+    uint32_t status = EVIC_disable_interrupts();
+    if(powerInhibit[mode] != 0)
+        powerInhibit[mode]--;
+    EVIC_restore_interrupts(status);
+}
+
+void        SYS_power_stats_get(SYS_Power_Stats *stats)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    *stats = powerStats;
+    stats->timeNs[SYS_POWER_RUN] = SYS_power_timestamp_get() - powerStatsStart -
+            powerStats.timeNs[SYS_POWER_IDLE] - powerStats.timeNs[SYS_POWER_SLEEP];
+    EVIC_restore_interrupts(status);
+}
+
+void        SYS_power_stats_reset(void)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    for(uint32_t i = 0; i < SYS_POWER_MODES; i++){
+        powerStats.timeNs[i] = 0;
+        powerStats.entries[i] = 0;
+    }
+    powerStatsStart = SYS_power_timestamp_get();
+    EVIC_restore_interrupts(status);
+}
+
+HAL_WEAK_FUNCTION uint64_t SYS_power_timestamp_get(void)
+{
+    return HAL_time_now_ns();
+}
+
+static void SYS_oscillator_switch(uint32_t source)
+{
+    SYSKEY = 0x00000000;
+    SYSKEY = 0xAA996655;
+    SYSKEY = 0x556699AA;
+    OSCCONbits.NOSC = source;
+    OSCCONSET = _OSCCON_OSWEN_MASK;
+    SYSKEY = 0x00000000;
+    /*OSWEN clears once the new source is running, for the PLL that includes the lock time*/
+    while(OSCCONbits.OSWEN);
+}
+
+static uint32_t SYS_flash_wait_states(uint32_t frequency)
+{
+    if(frequency <= 30000000UL)
+        return 0;
+    if(frequency <= 60000000UL)
+        return 1;
+    return 2;
+}
+
+/*The PIC32MX795 has no PMD registers, modules stay clocked and only the counts are kept*/
+static void SYS_pmd_power(uint32_t module, bool on)
+{
+    (void)module;
+    (void)on;
+}
+
+/*An inhibited mode falls back to the next lighter one*/
+static uint32_t SYS_power_enter(uint32_t mode)
+{
+    if(mode == SYS_POWER_SLEEP && powerInhibit[SYS_POWER_SLEEP] != 0)
+        mode = SYS_POWER_IDLE;
+    if(mode == SYS_POWER_IDLE && powerInhibit[SYS_POWER_IDLE] != 0)
+        return SYS_POWER_RUN;
+
+    uint32_t source = OSCCONbits.COSC;
+    SYSKEY = 0x00000000;
+    SYSKEY = 0xAA996655;
+    SYSKEY = 0x556699AA;
+    if(mode == SYS_POWER_SLEEP)
+        OSCCONSET = _OSCCON_SLPEN_MASK;
+    else
+        OSCCONCLR = _OSCCON_SLPEN_MASK;
+    SYSKEY = 0x00000000;
+
+    uint64_t start = SYS_power_timestamp_get();
+    _wait();
+
+    /*The oscillator restarts on its own, wait for the PLL before anything depends on the clock*/
+    if(mode == SYS_POWER_SLEEP){
+        if(OSCCONbits.COSC != source)
+            SYS_oscillator_switch(source);
+        if(source == SYS_OSC_FRCPLL || source == SYS_OSC_POSCPLL)
+            while(!OSCCONbits.SLOCK);
+    }
+    powerStats.timeNs[mode] += SYS_power_timestamp_get() - start;
+    powerStats.entries[mode]++;
+    return mode;
+}
@@ -0,0 +1,423 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "adc.h"
+#include "hal_family.h"
+#include "evic.h"
+#include "system.h"
+#include <xc.h>
+#include <string.h>
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+/*ADC0-ADC4 and the shared ADC7, ADCANCON ANENx and ADCCON3 DIGENx layout*/
+#define ADC_MODULES_MASK                    (0x9F)
+#define ADC_DEDICATED_MODULES               (5)
+/*Inputs with a TRGSRC field, AN0-AN11*/
+#define ADC_TRIGGER_SOURCE_INPUTS           (12)
+#define ADC_TRIGGER_SCAN                    (3)
+#define ADC_TRIGGER_SOURCE_MASK             (0x1F)
+
+/*TCLK is SYSCLK, TQ = TCLK/2 and TAD = 2*TQ stay within the 50 MHz TAD limit at any system clock*/
+#define ADC_CLOCK_SYSCLK                    (1)
+#define ADC_CLOCK_DIVIDER                   (1)
+#define ADC_TAD_DIVIDER                     (1)
+#define ADC_SAMPLE_TAD_MIN                  (2)
+#define ADC_SAMPLE_TAD_MAX                  (1025)
+#define ADC_WAKEUP_CLOCKS                   (5)
+
+#define ADC_RESOLUTION_MASK                 (0x0003)
+#define ADC_COMPARE_MASK                    (0x001F)
+#define ADC_FILTER_RATIO_MASK               (0x07)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+/*ADCDATAx are spaced like SFRs with CLR/SET/INV, 0x10 bytes apart*/
+#define ADC_DATA(input)                     (((volatile uint32_t*)&ADCDATA0)[4 * (input)])
+#define ADC_TIME_VALUE(selres, sampleTad)   (((selres) << _ADC0TIME_SELRES_POSITION) | \
+                                             (ADC_TAD_DIVIDER << _ADC0TIME_ADCDIV_POSITION) | \
+                                             (((sampleTad) - 2) << _ADC0TIME_SAMC_POSITION))
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    uint8_t         inputs[ADC_NUMBER_OF_INPUTS];
+    size_t          count;
+    uint16_t        *buffer;
+    size_t          frames;
+    size_t          head;
+    size_t          tail;
+    volatile size_t pending;
+    uint32_t        overruns;
+    ADC_Callback    callback;
+    uintptr_t       context;
+    bool            powered;
+}ADC_Object;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static ADC_Object adcObject;
+static volatile uint32_t * const adcTimeRegisters[ADC_DEDICATED_MODULES] = {
+        &ADC0TIME, &ADC1TIME, &ADC2TIME, &ADC3TIME, &ADC4TIME,
+};
+static volatile uint32_t * const adcTriggerRegisters[] = {
+        &ADCTRG1, &ADCTRG2, &ADCTRG3,
+};
+static volatile uint32_t * const adcFilterRegisters[ADC_NUMBER_OF_FILTERS] = {
+        &ADCFLTR1, &ADCFLTR2, &ADCFLTR3, &ADCFLTR4, &ADCFLTR5, &ADCFLTR6,
+};
+static volatile uint32_t * const adcCompareConRegisters[ADC_NUMBER_OF_COMPARATORS] = {
+        &ADCCMPCON1, &ADCCMPCON2, &ADCCMPCON3, &ADCCMPCON4, &ADCCMPCON5, &ADCCMPCON6,
+};
+static volatile uint32_t * const adcCompareRegisters[ADC_NUMBER_OF_COMPARATORS] = {
+        &ADCCMP1, &ADCCMP2, &ADCCMP3, &ADCCMP4, &ADCCMP5, &ADCCMP6,
+};
+static volatile uint32_t * const adcCompareEnRegisters[ADC_NUMBER_OF_COMPARATORS] = {
+        &ADCCMPEN1, &ADCCMPEN2, &ADCCMPEN3, &ADCCMPEN4, &ADCCMPEN5, &ADCCMPEN6,
+};
+/*OVRSAM in oversampling mode by ADC_FILTER_RATIO_x, averaging uses the ratio as is*/
+static const uint8_t adcOversampleCodes[ADC_FILTER_RATIO_MASK + 1] = {
+        4, 0, 5, 1, 6, 2, 7, 3,
+};
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static void ADC_trigger_source_set(uint32_t input, uint32_t source);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         ADC_initialize              (uint32_t configFlags, uint32_t sampleTad)
+{
+    if(sampleTad < ADC_SAMPLE_TAD_MIN || sampleTad > ADC_SAMPLE_TAD_MAX)
+        return -1;
+
+    if(!adcObject.powered){
+        SYS_pmd_acquire(SYS_PMD_ADC);
+        adcObject.powered = true;
+    }
+    ADCCON1 = 0;
+    ADCCON2 = 0;
+    ADCCON3 = 0;
+    ADCANCON = 0;
+
+    /*Factory calibration has to be in place before the module is switched on*/
+    ADC0CFG = DEVADC0;
+    ADC1CFG = DEVADC1;
+    ADC2CFG = DEVADC2;
+    ADC3CFG = DEVADC3;
+    ADC4CFG = DEVADC4;
+    ADC7CFG = DEVADC7;
+
+    uint32_t selres = 3 - (configFlags & ADC_RESOLUTION_MASK);
+    ADCCON1 = selres << _ADCCON1_SELRES_POSITION;
+    ADCCON2 = (ADC_TAD_DIVIDER << _ADCCON2_ADCDIV_POSITION) | ((sampleTad - 2) << _ADCCON2_SAMC_POSITION);
+    ADCCON3 = (ADC_CLOCK_SYSCLK << _ADCCON3_ADCSEL_POSITION) | (ADC_CLOCK_DIVIDER << _ADCCON3_CONCLKDIV_POSITION) |
+              ((configFlags & ADC_VREF_EXTERNAL) ? (1 << _ADCCON3_VREFSEL_POSITION) : 0);
+    for(uint32_t i = 0; i < ADC_DEDICATED_MODULES; i++)
+        *adcTimeRegisters[i] = ADC_TIME_VALUE(selres, sampleTad);
+
+    /*Single ended unsigned inputs, nothing scanned, triggered, filtered or compared*/
+    ADCIMCON1 = ADCIMCON2 = ADCIMCON3 = 0;
+    ADCGIRQEN1 = ADCGIRQEN2 = 0;
+    ADCCSS1 = ADCCSS2 = 0;
+    for(uint32_t i = 0; i < sizeof(adcTriggerRegisters) / sizeof(adcTriggerRegisters[0]); i++)
+        *adcTriggerRegisters[i] = 0;
+    for(uint32_t i = 0; i < ADC_NUMBER_OF_FILTERS; i++)
+        *adcFilterRegisters[i] = 0;
+    for(uint32_t i = 0; i < ADC_NUMBER_OF_COMPARATORS; i++)
+        *adcCompareConRegisters[i] = 0;
+
+    ADCCON1SET = _ADCCON1_ON_MASK;
+    while(!(ADCCON2 & _ADCCON2_BGVRRDY_MASK));
+    if(ADCCON2 & _ADCCON2_REFFLT_MASK)
+        return -1;
+
+    ADCANCON = (ADC_WAKEUP_CLOCKS << _ADCANCON_WKUPCLKCNT_POSITION) | ADC_MODULES_MASK;
+    uint32_t ready = ADC_MODULES_MASK << _ADCANCON_WKRDY0_POSITION;
+    while((ADCANCON & ready) != ready);
+    ADCCON3SET = ADC_MODULES_MASK << _ADCCON3_DIGEN0_POSITION;
+    return 0;
+}
+
+void        ADC_deinitialize            (void)
+{
+    ADC_stream_stop();
+    for(uint32_t i = 0; i < ADC_NUMBER_OF_FILTERS; i++)
+        ADC_filter_disable(i);
+    for(uint32_t i = 0; i < ADC_NUMBER_OF_COMPARATORS; i++)
+        ADC_comparator_disable(i);
+    ADCCON3CLR = ADC_MODULES_MASK << _ADCCON3_DIGEN0_POSITION;
+    ADCANCON = 0;
+    ADCCON1 = 0;
+    if(adcObject.powered){
+        adcObject.powered = false;
+        SYS_pmd_release(SYS_PMD_ADC);
+    }
+}
+
+uint16_t    ADC_read                    (uint32_t input)
+{
+    volatile uint32_t *status = input < 32 ? &ADCDSTAT1 : &ADCDSTAT2;
+    uint32_t mask = 1u << (input & 31);
+
+    ADCCON3CLR = _ADCCON3_ADINSEL_MASK;
+    ADCCON3SET = (input << _ADCCON3_ADINSEL_POSITION) | _ADCCON3_RQCNVRT_MASK;
+    while(!(*status & mask));
+    return ADC_DATA(input);
+}
+
+void        ADC_callback_register       (ADC_Callback callback, uintptr_t context)
+{
+    adcObject.callback = callback;
+    adcObject.context = context;
+}
+
+/*Every input of the sequence converts on the scan trigger, AN0-AN4 in parallel on their own modules*/
+int         ADC_scan_set                (const uint8_t *inputs, size_t count, uint32_t trigger)
+{
+    uint32_t css1 = 0, css2 = 0;
+
+    if(inputs == NULL || count == 0 || count > ADC_NUMBER_OF_INPUTS || adcObject.buffer != NULL)
+        return -1;
+    for(size_t i = 0; i < count; i++){
+        if(inputs[i] >= ADC_NUMBER_OF_INPUTS)
+            return -1;
+        if(inputs[i] < 32)
+            css1 |= 1u << inputs[i];
+        else
+            css2 |= 1u << (inputs[i] - 32);
+    }
+
+    ADCCON1CLR = _ADCCON1_STRGSRC_MASK;
+    for(uint32_t input = 0; input < ADC_TRIGGER_SOURCE_INPUTS; input++)
+        ADC_trigger_source_set(input, (css1 & (1u << input)) ? ADC_TRIGGER_SCAN : 0);
+    ADCCSS1 = css1;
+    ADCCSS2 = css2;
+    memcpy(adcObject.inputs, inputs, count);
+    adcObject.count = count;
+    ADCCON1SET = (trigger & ADC_TRIGGER_SOURCE_MASK) << _ADCCON1_STRGSRC_POSITION;
+    return 0;
+}
+
+void        ADC_scan_trigger            (void)
+{
+    ADCCON3SET = _ADCCON3_GSWTRG_MASK;
+}
+
+bool        ADC_stream_start            (uint16_t *buffer, size_t frames)
+{
+    if(buffer == NULL || frames == 0 || adcObject.count == 0)
+        return false;
+
+    ADC_stream_stop();
+    adcObject.head = adcObject.tail = 0;
+    adcObject.pending = 0;
+    adcObject.overruns = 0;
+    adcObject.frames = frames;
+    adcObject.buffer = buffer;
+    /*Scans run off the trigger, Sleep would stop its clock*/
+    SYS_power_inhibit(SYS_POWER_SLEEP);
+
+    (void)ADCCON2;
+    EVIC_channel_pending_clear(EVIC_CHANNEL_ADC_EOS);
+    ADCCON2SET = _ADCCON2_EOSIEN_MASK;
+    EVIC_channel_set(EVIC_CHANNEL_ADC_EOS);
+    return true;
+}
+
+void        ADC_stream_stop             (void)
+{
+    if(adcObject.buffer == NULL)
+        return;
+    EVIC_channel_clr(EVIC_CHANNEL_ADC_EOS);
+    ADCCON2CLR = _ADCCON2_EOSIEN_MASK;
+    adcObject.buffer = NULL;
+    SYS_power_allow(SYS_POWER_SLEEP);
+}
+
+size_t      ADC_stream_frames           (void)
+{
+    return adcObject.pending;
+}
+
+/*The interrupt never writes a frame that is still waiting, it is copied before being handed back*/
+bool        ADC_stream_read             (uint16_t *frame)
+{
+    if(adcObject.buffer == NULL || adcObject.pending == 0)
+        return false;
+
+    memcpy(frame, &adcObject.buffer[adcObject.tail * adcObject.count], adcObject.count * sizeof(uint16_t));
+    if(++adcObject.tail == adcObject.frames)
+        adcObject.tail = 0;
+    uint32_t status = EVIC_disable_interrupts();
+    adcObject.pending--;
+    EVIC_restore_interrupts(status);
+    return true;
+}
+
+uint32_t    ADC_stream_overruns_get     (void)
+{
+    return adcObject.overruns;
+}
+
+bool        ADC_dma_start               (uint32_t input, DMA_Channel dmaChannel, uint16_t *buffer, size_t count,
+                                         bool circular)
+{
+    if(input >= ADC_NUMBER_OF_INPUTS || buffer == NULL || count == 0 ||
+       count * sizeof(uint16_t) > DMA_MAX_TRANSFER_SIZE)
+        return false;
+
+    /*The data ready event triggers the transfer, the CPU interrupt stays disabled*/
+    EVIC_channel_clr(EVIC_CHANNEL_ADC_DATA0 + input);
+    if(input < 32)
+        ADCGIRQEN1SET = 1u << input;
+    else
+        ADCGIRQEN2SET = 1u << (input - 32);
+    DMA_channel_init(dmaChannel, DMA_CHANNEL_PRIORITY_3 | DMA_CHANNEL_START_IRQ | (circular ? DMA_CHANNEL_AUTO_ENABLE : 0));
+    DMA_CHANNEL_Config dmaConfig = {
+            .startIrq = EVIC_CHANNEL_ADC_DATA0 + input,
+            .cellSize = sizeof(uint16_t),
+            .srcSize = sizeof(uint16_t),
+            .srcAddress = (uint32_t)&ADC_DATA(input),
+            .dstSize = count * sizeof(uint16_t),
+            .dstAddress = (uint32_t)buffer,
+    };
+    DMA_channel_config(dmaChannel, &dmaConfig);
+    DMA_channel_enable(dmaChannel);
+    return true;
+}
+
+void        ADC_dma_stop                (uint32_t input, DMA_Channel dmaChannel)
+{
+    DMA_channel_abort(dmaChannel);
+    if(input < 32)
+        ADCGIRQEN1CLR = 1u << input;
+    else
+        ADCGIRQEN2CLR = 1u << (input - 32);
+}
+
+size_t      ADC_dma_index_get           (DMA_Channel dmaChannel)
+{
+    return DMA_channel_destination_pointer_get(dmaChannel) / sizeof(uint16_t);
+}
+
+int         ADC_filter_config           (uint32_t filter, uint32_t input, uint32_t flags, uint32_t ratio)
+{
+    if(filter >= ADC_NUMBER_OF_FILTERS || input >= ADC_NUMBER_OF_FILTERED_INPUTS || ratio > ADC_FILTER_RATIO_MASK)
+        return -1;
+
+    uint32_t value = input << _ADCFLTR1_CHNLID_POSITION;
+    /*Oversampled results grow past 12 bits*/
+    if(flags & ADC_FILTER_AVERAGE)
+        value |= _ADCFLTR1_DFMODE_MASK | (ratio << _ADCFLTR1_OVRSAM_POSITION);
+    else
+        value |= _ADCFLTR1_DATA16EN_MASK | (adcOversampleCodes[ratio] << _ADCFLTR1_OVRSAM_POSITION);
+
+    ADC_filter_disable(filter);
+    if(adcObject.callback != NULL){
+        value |= _ADCFLTR1_AFGIEN_MASK;
+        EVIC_channel_pending_clear(EVIC_CHANNEL_ADC_DF1 + filter);
+        EVIC_channel_set(EVIC_CHANNEL_ADC_DF1 + filter);
+    }
+    *adcFilterRegisters[filter] = value;
+    *adcFilterRegisters[filter] = value | _ADCFLTR1_AFEN_MASK;
+    return 0;
+}
+
+void        ADC_filter_disable          (uint32_t filter)
+{
+    EVIC_channel_clr(EVIC_CHANNEL_ADC_DF1 + filter);
+    *adcFilterRegisters[filter] = 0;
+}
+
+/*Reading the result clears AFRDY*/
+bool        ADC_filter_read             (uint32_t filter, uint16_t *value)
+{
+    uint32_t fltr = *adcFilterRegisters[filter];
+
+    if(!(fltr & _ADCFLTR1_AFRDY_MASK))
+        return false;
+    *value = fltr & _ADCFLTR1_FLTRDATA_MASK;
+    return true;
+}
+
+/*high and low are compared against the result as it lands in ADCDATAx, an event fires once per matching conversion*/
+int         ADC_comparator_config       (uint32_t comparator, uint32_t inputMask, uint16_t low, uint16_t high,
+                                         uint32_t flags)
+{
+    if(comparator >= ADC_NUMBER_OF_COMPARATORS || (flags & ADC_COMPARE_MASK) == 0)
+        return -1;
+
+    uint32_t con = (flags & ADC_COMPARE_MASK) | _ADCCMPCON1_ENDCMP_MASK;
+    ADC_comparator_disable(comparator);
+    *adcCompareRegisters[comparator] = ((uint32_t)high << 16) | low;
+    *adcCompareEnRegisters[comparator] = inputMask;
+    if(adcObject.callback != NULL){
+        con |= _ADCCMPCON1_DCMPGIEN_MASK;
+        EVIC_channel_pending_clear(EVIC_CHANNEL_ADC_DC1 + comparator);
+        EVIC_channel_set(EVIC_CHANNEL_ADC_DC1 + comparator);
+    }
+    *adcCompareConRegisters[comparator] = con;
+    return 0;
+}
+
+void        ADC_comparator_disable      (uint32_t comparator)
+{
+    EVIC_channel_clr(EVIC_CHANNEL_ADC_DC1 + comparator);
+    *adcCompareConRegisters[comparator] = 0;
+}
+
+/*One interrupt per scan, the whole frame is copied here*/
+void        ADC_scan_interrupt_handler  (void)
+{
+    /*Reading ADCCON2 clears EOSRDY*/
+    (void)ADCCON2;
+    EVIC_channel_pending_clear(EVIC_CHANNEL_ADC_EOS);
+    if(adcObject.buffer == NULL)
+        return;
+
+    if(adcObject.pending == adcObject.frames){
+        adcObject.overruns++;
+        if(adcObject.callback != NULL)
+            adcObject.callback(ADC_EVENT_OVERRUN, 0, adcObject.pending, adcObject.context);
+        return;
+    }
+    uint16_t *frame = &adcObject.buffer[adcObject.head * adcObject.count];
+    for(size_t i = 0; i < adcObject.count; i++)
+        frame[i] = ADC_DATA(adcObject.inputs[i]);
+    if(++adcObject.head == adcObject.frames)
+        adcObject.head = 0;
+    adcObject.pending++;
+    if(adcObject.callback != NULL)
+        adcObject.callback(ADC_EVENT_FRAME, 0, adcObject.pending, adcObject.context);
+}
+
+void        ADC_filter_interrupt_handler(uint32_t filter)
+{
+    uint16_t value;
+
+    if(ADC_filter_read(filter, &value) && adcObject.callback != NULL)
+        adcObject.callback(ADC_EVENT_FILTER, filter, value, adcObject.context);
+    EVIC_channel_pending_clear(EVIC_CHANNEL_ADC_DF1 + filter);
+}
+
+/*Reading ADCCMPCONx clears DCMPED*/
+void        ADC_comparator_interrupt_handler(uint32_t comparator)
+{
+    uint32_t con = *adcCompareConRegisters[comparator];
+    uint32_t input = (con & _ADCCMPCON1_AINID_MASK) >> _ADCCMPCON1_AINID_POSITION;
+
+    EVIC_channel_pending_clear(EVIC_CHANNEL_ADC_DC1 + comparator);
+    if(adcObject.callback != NULL)
+        adcObject.callback(ADC_EVENT_COMPARATOR, comparator, input, adcObject.context);
+}
+
+/*TRGSRCx are 5 bit fields, four to a register*/
+static void ADC_trigger_source_set(uint32_t input, uint32_t source)
+{
+    volatile uint32_t *reg = adcTriggerRegisters[input / 4];
+    uint32_t shift = 8 * (input % 4);
+
+    *reg = (*reg & ~(ADC_TRIGGER_SOURCE_MASK << shift)) | (source << shift);
+}
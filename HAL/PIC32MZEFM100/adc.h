@@ -0,0 +1,151 @@
+/**
+ * @file adc.h
+ * @brief PIC32MZ 12 bit ADC. AN0-AN4 convert on their dedicated modules, the other inputs on the shared one. A scan
+ * sequence converts a list of inputs on every trigger; a timer period match (TMR_CHANNEL_3 or TMR_CHANNEL_5 set up
+ * with the timer driver) paces it without the CPU. Results leave either as frames, one sample per scanned input copied
+ * from the end of scan interrupt into a circular buffer, or input by input straight from ADCDATAx by DMA.
+ * The six digital filters oversample or average an input in hardware, the six digital comparators raise an event when
+ * a conversion leaves or enters a window. ADC_scan_interrupt_handler, ADC_filter_interrupt_handler and
+ * ADC_comparator_interrupt_handler must be called from the ADC_EOS, ADC_DFx and ADC_DCx vectors in use.
+ */
+
+#ifndef ADC_H
+#define ADC_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "dma.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#define ADC_NUMBER_OF_INPUTS                (45)
+/*Filters and comparators only reach AN0-AN31*/
+#define ADC_NUMBER_OF_FILTERED_INPUTS       (32)
+#define ADC_NUMBER_OF_FILTERS               (6)
+#define ADC_NUMBER_OF_COMPARATORS           (6)
+
+/*Configuration Flags*/
+#define ADC_RESOLUTION_12                   (0x0000)
+#define ADC_RESOLUTION_10                   (0x0001)
+#define ADC_RESOLUTION_8                    (0x0002)
+#define ADC_RESOLUTION_6                    (0x0003)
+#define ADC_VREF_AVDD                       (0x0000)
+#define ADC_VREF_EXTERNAL                   (0x0010)
+
+/*Sample time in TAD, TAD is SYSCLK/4*/
+#define ADC_SAMPLE_TAD_DEFAULT              (5)
+
+/*Scan trigger sources, ADCCON1 STRGSRC encoding*/
+#define ADC_TRIGGER_SOFTWARE                (1)
+#define ADC_TRIGGER_INT0                    (4)
+#define ADC_TRIGGER_TMR1                    (5)
+#define ADC_TRIGGER_TMR3                    (6)
+#define ADC_TRIGGER_TMR5                    (7)
+#define ADC_TRIGGER_OC1                     (8)
+#define ADC_TRIGGER_OC3                     (9)
+#define ADC_TRIGGER_OC5                     (10)
+#define ADC_TRIGGER_COMPARATOR_1            (11)
+#define ADC_TRIGGER_COMPARATOR_2            (12)
+
+#define ADC_FILTER_1                        (0)
+#define ADC_FILTER_2                        (1)
+#define ADC_FILTER_3                        (2)
+#define ADC_FILTER_4                        (3)
+#define ADC_FILTER_5                        (4)
+#define ADC_FILTER_6                        (5)
+/*Oversampling adds one bit of resolution per 4x, averaging keeps it*/
+#define ADC_FILTER_OVERSAMPLE               (0x0000)
+#define ADC_FILTER_AVERAGE                  (0x0001)
+/*Samples per result, OVRSAM has a different encoding per mode and ADC_filter_config translates*/
+#define ADC_FILTER_RATIO_2                  (0)
+#define ADC_FILTER_RATIO_4                  (1)
+#define ADC_FILTER_RATIO_8                  (2)
+#define ADC_FILTER_RATIO_16                 (3)
+#define ADC_FILTER_RATIO_32                 (4)
+#define ADC_FILTER_RATIO_64                 (5)
+#define ADC_FILTER_RATIO_128                (6)
+#define ADC_FILTER_RATIO_256                (7)
+
+#define ADC_COMPARATOR_1                    (0)
+#define ADC_COMPARATOR_2                    (1)
+#define ADC_COMPARATOR_3                    (2)
+#define ADC_COMPARATOR_4                    (3)
+#define ADC_COMPARATOR_5                    (4)
+#define ADC_COMPARATOR_6                    (5)
+/*Event conditions, any combination, ADCCMPCONx IExxxx encoding*/
+#define ADC_COMPARE_BELOW_LOW               (0x0001)
+#define ADC_COMPARE_ABOVE_LOW               (0x0002)
+#define ADC_COMPARE_BELOW_HIGH              (0x0004)
+#define ADC_COMPARE_ABOVE_HIGH              (0x0008)
+#define ADC_COMPARE_BETWEEN                 (0x0010)
+#define ADC_COMPARE_OUTSIDE                 (ADC_COMPARE_BELOW_LOW | ADC_COMPARE_ABOVE_HIGH)
+/**********************************************************************
+* Preprocessor Macros
+**********************************************************************/
+#define ADC_INPUT_MASK(input)               (1u << (input))
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef enum{
+    ADC_EVENT_FRAME,
+    ADC_EVENT_OVERRUN,
+    ADC_EVENT_FILTER,
+    ADC_EVENT_COMPARATOR
+}ADC_EVENT;
+
+/*Frames: index 0 and value the frames waiting. Filters: the filter and its result. Comparators: the comparator and
+the input that matched*/
+typedef void (*ADC_Callback)(ADC_EVENT event, uint32_t index, uint32_t value, uintptr_t context);
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         ADC_initialize              (uint32_t configFlags, uint32_t sampleTad);
+void        ADC_deinitialize            (void);
+/*Single conversion by software request, busy waits for the result*/
+uint16_t    ADC_read                    (uint32_t input);
+void        ADC_callback_register       (ADC_Callback callback, uintptr_t context);
+
+int         ADC_scan_set                (const uint8_t *inputs, size_t count, uint32_t trigger);
+void        ADC_scan_trigger            (void);
+/*buffer holds frames * count samples, frames come out in the order the inputs were given to ADC_scan_set*/
+bool        ADC_stream_start            (uint16_t *buffer, size_t frames);
+void        ADC_stream_stop             (void);
+size_t      ADC_stream_frames           (void);
+bool        ADC_stream_read             (uint16_t *frame);
+uint32_t    ADC_stream_overruns_get     (void);
+
+/*The data ready event of input triggers the transfer, count samples of 16 bit. The buffer must be placed in coherent
+(uncached) memory*/
+bool        ADC_dma_start               (uint32_t input, DMA_Channel dmaChannel, uint16_t *buffer, size_t count,
+                                         bool circular);
+void        ADC_dma_stop                (uint32_t input, DMA_Channel dmaChannel);
+size_t      ADC_dma_index_get           (DMA_Channel dmaChannel);
+
+/*The filter takes every conversion of input, which has to be scanned or triggered to produce results. Filter and
+comparator interrupts are only enabled when a callback is registered*/
+int         ADC_filter_config           (uint32_t filter, uint32_t input, uint32_t flags, uint32_t ratio);
+void        ADC_filter_disable          (uint32_t filter);
+bool        ADC_filter_read             (uint32_t filter, uint16_t *value);
+int         ADC_comparator_config       (uint32_t comparator, uint32_t inputMask, uint16_t low, uint16_t high,
+                                         uint32_t flags);
+void        ADC_comparator_disable      (uint32_t comparator);
+
+void        ADC_scan_interrupt_handler  (void);
+void        ADC_filter_interrupt_handler(uint32_t filter);
+void        ADC_comparator_interrupt_handler(uint32_t comparator);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //ADC_H
@@ -0,0 +1,253 @@
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "cache.h"
+#include "system.h"
+#include <xc.h>
+#include <sys/kmem.h>
+#include <string.h>
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+/*MIPS32 CACHE instruction operations*/
+#define CACHE_INDEX_INVALIDATE_I            (0x00)
+#define CACHE_INDEX_WRITEBACK_INVALIDATE_D  (0x01)
+#define CACHE_HIT_INVALIDATE_I              (0x10)
+#define CACHE_HIT_INVALIDATE_D              (0x11)
+#define CACHE_HIT_WRITEBACK_INVALIDATE_D    (0x15)
+#define CACHE_HIT_WRITEBACK_D               (0x19)
+#define CACHE_FETCH_LOCK_I                  (0x1C)
+#define CACHE_FETCH_LOCK_D                  (0x1D)
+
+#define CACHE_KSEG0_BASE                    (0x80000000UL)
+#define CACHE_POLICY_MASK                   (7)
+#define CACHE_K0_POSITION                   (0)
+#define CACHE_KU_POSITION                   (25)
+#define CACHE_K23_POSITION                  (28)
+#define CACHE_SOFTWARE_0_CAUSE              (0x0100)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+#define CACHE_OP(op, address)               __asm__ __volatile__("cache %0, 0(%1)" : : "i"(op), "r"(address) : "memory")
+#define CACHE_SYNC()                        __asm__ __volatile__("sync" : : : "memory")
+/*CP0 Config1 geometry fields, sizes come out in bytes*/
+#define CACHE_LINE(l)                       ((l) ? (2u << (l)) : 0)
+#define CACHE_SIZE(s, l, a)                 (CACHE_LINE(l) * (64u << (s)) * ((a) + 1))
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef void (*SYS_Cache_Config_Write)(uint32_t config);
+
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static volatile uint32_t benchmarkIsrCount;
+static volatile bool benchmarkIsrDone;
+static const uint32_t segmentPositions[] = {
+        [SYS_CACHE_SEGMENT_KSEG0]   = CACHE_K0_POSITION,
+        [SYS_CACHE_SEGMENT_KSEG23]  = CACHE_K23_POSITION,
+        [SYS_CACHE_SEGMENT_KUSEG]   = CACHE_KU_POSITION,
+};
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static uint32_t SYS_cache_line_size(void);
+static void SYS_cache_config_write(uint32_t config) __attribute__((noinline));
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+void        SYS_cache_info_get              (SYS_Cache_Info *info)
+{
+    uint32_t config1 = _CP0_GET_CONFIG1();
+
+    info->lineSize = CACHE_LINE((config1 & _CP0_CONFIG1_DL_MASK) >> _CP0_CONFIG1_DL_POSITION);
+    info->dCacheSize = CACHE_SIZE((config1 & _CP0_CONFIG1_DS_MASK) >> _CP0_CONFIG1_DS_POSITION,
+                                  (config1 & _CP0_CONFIG1_DL_MASK) >> _CP0_CONFIG1_DL_POSITION,
+                                  (config1 & _CP0_CONFIG1_DA_MASK) >> _CP0_CONFIG1_DA_POSITION);
+    info->iCacheSize = CACHE_SIZE((config1 & _CP0_CONFIG1_IS_MASK) >> _CP0_CONFIG1_IS_POSITION,
+                                  (config1 & _CP0_CONFIG1_IL_MASK) >> _CP0_CONFIG1_IL_POSITION,
+                                  (config1 & _CP0_CONFIG1_IA_MASK) >> _CP0_CONFIG1_IA_POSITION);
+    info->ways = ((config1 & _CP0_CONFIG1_DA_MASK) >> _CP0_CONFIG1_DA_POSITION) + 1;
+}
+
+void        SYS_cache_policy_set            (uint32_t segment, uint32_t policy)
+{
+    if(segment > SYS_CACHE_SEGMENT_KUSEG)
+        return;
+
+    uint32_t status = EVIC_disable_interrupts();
+    /*Dirty lines would be lost once the segment stops being write back*/
+    SYS_cache_data_flush_all();
+    uint32_t config = _CP0_GET_CONFIG();
+    config &= ~(CACHE_POLICY_MASK << segmentPositions[segment]);
+    config |= (policy & CACHE_POLICY_MASK) << segmentPositions[segment];
+    /*K0 may only change while fetching from uncached space, the write runs from the KSEG1 alias of its code*/
+    SYS_Cache_Config_Write write = (SYS_Cache_Config_Write)KVA0_TO_KVA1((uintptr_t)SYS_cache_config_write);
+    write(config);
+    SYS_cache_instruction_invalidate_all();
+    EVIC_restore_interrupts(status);
+}
+
+uint32_t    SYS_cache_policy_get            (uint32_t segment)
+{
+    if(segment > SYS_CACHE_SEGMENT_KUSEG)
+        return SYS_CACHE_UNCACHED;
+    return (_CP0_GET_CONFIG() >> segmentPositions[segment]) & CACHE_POLICY_MASK;
+}
+
+void        SYS_cache_prefetch_set          (uint32_t mode)
+{
+    PRECONbits.PREFEN = mode & 3;
+}
+
+void        SYS_cache_data_flush            (const void *address, size_t size)
+{
+    uint32_t line = SYS_cache_line_size();
+    uintptr_t end = (uintptr_t)address + size;
+
+    for(uintptr_t a = (uintptr_t)address & ~(line - 1); a < end; a += line)
+        CACHE_OP(CACHE_HIT_WRITEBACK_D, a);
+    CACHE_SYNC();
+}
+
+/*Partial lines at either end are written back first so neighbouring data is not dropped*/
+void        SYS_cache_data_invalidate       (void *address, size_t size)
+{
+    uint32_t line = SYS_cache_line_size();
+    uintptr_t start = (uintptr_t)address;
+    uintptr_t end = start + size;
+
+    if(start & (line - 1))
+        CACHE_OP(CACHE_HIT_WRITEBACK_INVALIDATE_D, start & ~(line - 1));
+    if(end & (line - 1))
+        CACHE_OP(CACHE_HIT_WRITEBACK_INVALIDATE_D, end & ~(line - 1));
+    for(uintptr_t a = start & ~(line - 1); a < end; a += line)
+        CACHE_OP(CACHE_HIT_INVALIDATE_D, a);
+    CACHE_SYNC();
+}
+
+void        SYS_cache_data_flush_invalidate (void *address, size_t size)
+{
+    uint32_t line = SYS_cache_line_size();
+    uintptr_t end = (uintptr_t)address + size;
+
+    for(uintptr_t a = (uintptr_t)address & ~(line - 1); a < end; a += line)
+        CACHE_OP(CACHE_HIT_WRITEBACK_INVALIDATE_D, a);
+    CACHE_SYNC();
+}
+
+void        SYS_cache_data_flush_all        (void)
+{
+    SYS_Cache_Info info;
+    SYS_cache_info_get(&info);
+
+    /*Index operations walk every set of every way, the KSEG0 address only selects the index*/
+    for(uintptr_t a = CACHE_KSEG0_BASE; a < CACHE_KSEG0_BASE + info.dCacheSize; a += info.lineSize)
+        CACHE_OP(CACHE_INDEX_WRITEBACK_INVALIDATE_D, a);
+    CACHE_SYNC();
+}
+
+void        SYS_cache_instruction_invalidate(const void *address, size_t size)
+{
+    uint32_t line = SYS_cache_line_size();
+    uintptr_t end = (uintptr_t)address + size;
+
+    for(uintptr_t a = (uintptr_t)address & ~(line - 1); a < end; a += line)
+        CACHE_OP(CACHE_HIT_INVALIDATE_I, a);
+    CACHE_SYNC();
+    _ehb();
+}
+
+void        SYS_cache_instruction_invalidate_all(void)
+{
+    SYS_Cache_Info info;
+    SYS_cache_info_get(&info);
+
+    for(uintptr_t a = CACHE_KSEG0_BASE; a < CACHE_KSEG0_BASE + info.iCacheSize; a += info.lineSize)
+        CACHE_OP(CACHE_INDEX_INVALIDATE_I, a);
+    CACHE_SYNC();
+    _ehb();
+}
+
+void        SYS_cache_instruction_lock      (const void *address, size_t size)
+{
+    uint32_t line = SYS_cache_line_size();
+    uintptr_t end = (uintptr_t)address + size;
+
+    for(uintptr_t a = (uintptr_t)address & ~(line - 1); a < end; a += line)
+        CACHE_OP(CACHE_FETCH_LOCK_I, a);
+    CACHE_SYNC();
+}
+
+void        SYS_cache_data_lock             (const void *address, size_t size)
+{
+    uint32_t line = SYS_cache_line_size();
+    uintptr_t end = (uintptr_t)address + size;
+
+    for(uintptr_t a = (uintptr_t)address & ~(line - 1); a < end; a += line)
+        CACHE_OP(CACHE_FETCH_LOCK_D, a);
+    CACHE_SYNC();
+}
+
+/*Hit invalidate clears the lock bit, data lines are written back first*/
+void        SYS_cache_unlock                (const void *address, size_t size)
+{
+    SYS_cache_data_flush_invalidate((void*)address, size);
+    SYS_cache_instruction_invalidate(address, size);
+}
+
+void        SYS_cache_benchmark_run         (SYS_Cache_Benchmark *result, EVIC_CHANNEL swChannel, void *dst,
+                                             const void *src, size_t size)
+{
+    uint32_t cause = swChannel == EVIC_CHANNEL_CORE_SOFTWARE_0 ? CACHE_SOFTWARE_0_CAUSE : CACHE_SOFTWARE_0_CAUSE << 1;
+
+    /*Core timer ticks are SYSCLK/2, results are scaled to cycles*/
+    uint32_t start = _CP0_GET_COUNT();
+    memcpy(dst, src, size);
+    result->memcpyCycles = (_CP0_GET_COUNT() - start) << 1;
+    result->bytesPerKCycle = result->memcpyCycles ? ((uint64_t)size * 1000) / result->memcpyCycles : 0;
+
+    benchmarkIsrDone = false;
+    EVIC_channel_pending_clear(swChannel);
+    EVIC_channel_set(swChannel);
+    start = _CP0_GET_COUNT();
+    _CP0_BIS_CAUSE(cause);
+    while(!benchmarkIsrDone);
+    result->isrLatency = (benchmarkIsrCount - start) << 1;
+    EVIC_channel_clr(swChannel);
+}
+
+void        SYS_cache_benchmark_all         (SYS_Cache_Benchmark result[SYS_CACHE_POLICY_COUNT], EVIC_CHANNEL swChannel,
+                                             void *dst, const void *src, size_t size)
+{
+    uint32_t policy = SYS_cache_policy_get(SYS_CACHE_SEGMENT_KSEG0);
+
+    for(uint32_t i = 0; i < SYS_CACHE_POLICY_COUNT; i++){
+        SYS_cache_policy_set(SYS_CACHE_SEGMENT_KSEG0, i);
+        /*First pass warms the cache, the second is the one reported*/
+        SYS_cache_benchmark_run(&result[i], swChannel, dst, src, size);
+        SYS_cache_benchmark_run(&result[i], swChannel, dst, src, size);
+    }
+    SYS_cache_policy_set(SYS_CACHE_SEGMENT_KSEG0, policy);
+}
+
+void        SYS_cache_benchmark_isr         (void)
+{
+    benchmarkIsrCount = _CP0_GET_COUNT();
+    _CP0_BIC_CAUSE(CACHE_SOFTWARE_0_CAUSE | (CACHE_SOFTWARE_0_CAUSE << 1));
+    EVIC_channel_pending_clear(EVIC_CHANNEL_CORE_SOFTWARE_0);
+    EVIC_channel_pending_clear(EVIC_CHANNEL_CORE_SOFTWARE_1);
+    benchmarkIsrDone = true;
+}
+
+static uint32_t SYS_cache_line_size(void)
+{
+    uint32_t config1 = _CP0_GET_CONFIG1();
+    return CACHE_LINE((config1 & _CP0_CONFIG1_DL_MASK) >> _CP0_CONFIG1_DL_POSITION);
+}
+
+static void SYS_cache_config_write(uint32_t config)
+{
+    _CP0_SET_CONFIG(config);
+    _ehb();
+}
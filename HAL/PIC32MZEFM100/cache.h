@@ -0,0 +1,90 @@
+/**
+ * @file cache.h
+ * @brief PIC32MZ L1 cache and flash prefetch control. Cacheability is set per segment through CP0 Config, lines can be
+ * written back, invalidated or locked by address range. Buffers shared with DMA either live in KSEG1 or are flushed
+ * before a transfer out and invalidated before reading what came in.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "evic.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+/*Cache coherency attributes, CP0 Config K0/K23/KU encoding*/
+#define SYS_CACHE_WRITE_THROUGH_NO_ALLOCATE (0)
+#define SYS_CACHE_WRITE_THROUGH             (1)
+#define SYS_CACHE_UNCACHED                  (2)
+#define SYS_CACHE_WRITE_BACK                (3)
+#define SYS_CACHE_POLICY_COUNT              (4)
+
+#define SYS_CACHE_SEGMENT_KSEG0             (0)
+#define SYS_CACHE_SEGMENT_KSEG23            (1)
+#define SYS_CACHE_SEGMENT_KUSEG             (2)
+
+/*PRECON PREFEN*/
+#define SYS_PREFETCH_DISABLED               (0)
+#define SYS_PREFETCH_CACHEABLE              (1)
+#define SYS_PREFETCH_NON_CACHEABLE          (2)
+#define SYS_PREFETCH_ALL                    (3)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef struct{
+    uint32_t    lineSize;
+    uint32_t    iCacheSize;
+    uint32_t    dCacheSize;
+    uint32_t    ways;
+}SYS_Cache_Info;
+
+/*All figures in SYSCLK cycles*/
+typedef struct{
+    uint32_t    isrLatency;
+    uint32_t    memcpyCycles;
+    uint32_t    bytesPerKCycle;
+}SYS_Cache_Benchmark;
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+void        SYS_cache_info_get              (SYS_Cache_Info *info);
+void        SYS_cache_policy_set            (uint32_t segment, uint32_t policy);
+uint32_t    SYS_cache_policy_get            (uint32_t segment);
+void        SYS_cache_prefetch_set          (uint32_t mode);
+
+void        SYS_cache_data_flush            (const void *address, size_t size);
+void        SYS_cache_data_invalidate       (void *address, size_t size);
+void        SYS_cache_data_flush_invalidate (void *address, size_t size);
+void        SYS_cache_data_flush_all        (void);
+void        SYS_cache_instruction_invalidate(const void *address, size_t size);
+void        SYS_cache_instruction_invalidate_all(void);
+
+/*Locked lines are never evicted, keep the total well below one way per cache*/
+void        SYS_cache_instruction_lock      (const void *address, size_t size);
+void        SYS_cache_data_lock             (const void *address, size_t size);
+void        SYS_cache_unlock                (const void *address, size_t size);
+
+/*The ISR of swChannel (EVIC_CHANNEL_CORE_SOFTWARE_0 or _1) must call SYS_cache_benchmark_isr*/
+void        SYS_cache_benchmark_run         (SYS_Cache_Benchmark *result, EVIC_CHANNEL swChannel, void *dst,
+                                             const void *src, size_t size);
+void        SYS_cache_benchmark_all         (SYS_Cache_Benchmark result[SYS_CACHE_POLICY_COUNT], EVIC_CHANNEL swChannel,
+                                             void *dst, const void *src, size_t size);
+void        SYS_cache_benchmark_isr         (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //CACHE_H
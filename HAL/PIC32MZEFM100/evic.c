@@ -108,6 +108,13 @@ void        EVIC_channel_clr(EVIC_CHANNEL channel)
     int bitOffset = 1<<(channel & 0x1f);
     (iec_base+offset)->clr = bitOffset;
 }
+bool        EVIC_channel_get(EVIC_CHANNEL channel)
+{
+    uint32_t offset;
+    offset = channel >> 5;
+    int bitOffset = 1<<(channel & 0x1f);
+    return ((iec_base+offset)->reg & bitOffset) == bitOffset;
+}
 uint32_t    EVIC_enable_interrupts( void )
 {
     return __builtin_enable_interrupts();
@@ -253,6 +253,7 @@ int         EVIC_channel_state_Set(
 void        EVIC_channel_priority(EVIC_CHANNEL channel, EVIC_PRIORITY, EVIC_SUB_PRIORITY);
 void        EVIC_channel_set(EVIC_CHANNEL channel);
 void        EVIC_channel_clr(EVIC_CHANNEL channel);
+bool        EVIC_channel_get(EVIC_CHANNEL channel);
 bool        EVIC_channel_pending_get(EVIC_CHANNEL channel);
 void        EVIC_channel_pending_clear(EVIC_CHANNEL);
 uint32_t    EVIC_enable_interrupts( void );
@@ -6,6 +6,7 @@
 #include "gpio.h"
 #include "pic32mz_registers.h"
 #include "evic.h"
+#include "system.h"
 
 /**********************************************************************
 * Module Preprocessor Constants
@@ -15,6 +16,7 @@
 #define GPIO_PORT_IRQ_CHANNEL(port)     (EVIC_CHANNEL_CHANGE_NOTICE_A+(port))
 #define GPIO_PIN(val)                   (val & GPIO_PIN_MASK)
 #define GPIO_MAX_PINS                   (112)
+#define GPIO_NUMBER_OF_PORTS            (10)
 /*********************************************************************
 * Module Preprocessor Macros
 **********************************************************************/
@@ -23,10 +25,24 @@
 /**********************************************************************
 * Module Typedefs
 **********************************************************************/
+/*Per port masks a pin table is folded into*/
+typedef struct{
+    uint16_t    used;
+    uint16_t    analog;
+    uint16_t    output;
+    uint16_t    high;
+    uint16_t    openDrain;
+    uint16_t    srcon0;
+    uint16_t    srcon1;
+    uint16_t    pullUp;
+    uint16_t    pullDown;
+    uint16_t    irq;
+}GPIO_PortConfig;
 
 /**********************************************************************
 * Module Variable Definitions
 **********************************************************************/
+static GPIO_CALLBACK_OBJECT gpioCallbacks[GPIO_NUMBER_OF_PORTS][GPIO_CALLBACKS_PER_PORT];
 
 /**********************************************************************
 * Function Prototypes
@@ -45,6 +61,8 @@ void    GPIO_pin_initialize             (GPIO_PinMap pin, int flags)
 
     GPIO_PORT(pin>>GPIO_PORT_SHIFT)->ansel.clr = GPIO_PIN(pin);
     if(flags & GPIO_OUTPUT){
+        if(flags & GPIO_INIT_HIGH)
+            GPIO_PORT(pin>>GPIO_PORT_SHIFT)->lat.set = GPIO_PIN(pin);
         GPIO_PORT(pin>>GPIO_PORT_SHIFT)->tris.clr = GPIO_PIN(pin);
         if(flags & GPIO_OPENDRAIN)
             GPIO_PORT(pin>>GPIO_PORT_SHIFT)->odc.set = GPIO_PIN(pin);
@@ -111,7 +129,14 @@ void    GPIO_pin_toggle            (GPIO_PinMap pin)
 
 void GPIO_port_write(GPIO_Port port, uint32_t value, uint32_t mask)
 {
-    GPIO_PORT(port)->lat.reg = value & mask;
+    /*Pins outside the mask are never touched, each pin changes at most once*/
+    GPIO_PORT(port)->lat.clr = ~value & mask;
+    GPIO_PORT(port)->lat.set = value & mask;
+}
+void    GPIO_port_modify                (GPIO_Port port, uint32_t setMask, uint32_t clrMask)
+{
+    GPIO_PORT(port)->lat.clr = clrMask & ~setMask;
+    GPIO_PORT(port)->lat.set = setMask;
 }
 uint32_t    GPIO_port_read                  (GPIO_Port port, uint32_t mask)
 {
@@ -122,14 +147,158 @@ void    GPIO_port_toggle                (GPIO_Port port, uint32_t mask)
     GPIO_PORT(port)->lat.inv = mask;
 }
 
+int     GPIO_group_initialize           (GPIO_Group *group, const GPIO_PinMap *pins, size_t count, int flags)
+{
+    if(count > GPIO_GROUP_MAX_PINS)
+        return -1;
+
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++)
+        group->masks[p] = 0;
+    for(size_t i = 0; i < count; i++){
+        group->pins[i] = pins[i];
+        group->masks[pins[i] >> GPIO_PORT_SHIFT] |= GPIO_PIN(pins[i]);
+        GPIO_pin_initialize(pins[i], flags);
+    }
+    group->count = count;
+    return 0;
+}
+void    GPIO_group_set                  (const GPIO_Group *group)
+{
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            GPIO_PORT(p)->lat.set = group->masks[p];
+    }
+}
+void    GPIO_group_clear                (const GPIO_Group *group)
+{
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            GPIO_PORT(p)->lat.clr = group->masks[p];
+    }
+}
+void    GPIO_group_toggle               (const GPIO_Group *group)
+{
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            GPIO_PORT(p)->lat.inv = group->masks[p];
+    }
+}
+void    GPIO_group_write                (const GPIO_Group *group, uint32_t value)
+{
+    uint16_t setMasks[GPIO_GROUP_MAX_PORTS] = {0};
+
+    /*Bit i of value drives the i-th pin of the group*/
+    for(uint32_t i = 0; i < group->count; i++){
+        if(value & (1u << i))
+            setMasks[group->pins[i] >> GPIO_PORT_SHIFT] |= GPIO_PIN(group->pins[i]);
+    }
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            GPIO_port_modify(p, setMasks[p], group->masks[p]);
+    }
+}
+uint32_t GPIO_group_read                (const GPIO_Group *group)
+{
+    uint32_t ports[GPIO_GROUP_MAX_PORTS] = {0};
+    uint32_t value = 0;
+
+    for(int p = 0; p < GPIO_GROUP_MAX_PORTS; p++){
+        if(group->masks[p])
+            ports[p] = GPIO_PORT(p)->port.reg;
+    }
+    for(uint32_t i = 0; i < group->count; i++){
+        if(ports[group->pins[i] >> GPIO_PORT_SHIFT] & GPIO_PIN(group->pins[i]))
+            value |= 1u << i;
+    }
+    return value;
+}
+
 void    GPIO_pin_interrupt_set     (GPIO_PinMap pin, bool state)
 {
-    if(state)
+    if(state){
         GPIO_PORT(pin>>GPIO_PORT_SHIFT)->cnen.set = GPIO_PIN(pin);
+        GPIO_PORT(pin>>GPIO_PORT_SHIFT)->cncon.set = _CNCONA_ON_MASK;
+    }
     else
         GPIO_PORT(pin>>GPIO_PORT_SHIFT)->cnen.clr = GPIO_PIN(pin);
 }
 
+void    GPIO_pin_table_apply            (const GPIO_PinConfig *table, size_t count)
+{
+    GPIO_PortConfig ports[GPIO_NUMBER_OF_PORTS] = {0};
+    bool remap = false;
+
+    for(size_t i = 0; i < count; i++){
+        GPIO_PortConfig *cfg = &ports[table[i].pin >> GPIO_PORT_SHIFT];
+        uint32_t flags = table[i].flags;
+        uint32_t mask = GPIO_PIN(table[i].pin);
+
+        cfg->used |= mask;
+        remap |= table[i].ppsRegister != NULL;
+        if(flags & GPIO_ANALOG){
+            cfg->analog |= mask;
+            continue;
+        }
+        if(flags & GPIO_OUTPUT){
+            cfg->output |= mask;
+            if(flags & GPIO_INIT_HIGH)
+                cfg->high |= mask;
+            if(flags & GPIO_OPENDRAIN)
+                cfg->openDrain |= mask;
+            if(flags & (GPIO_SLOWEST | GPIO_FAST))
+                cfg->srcon0 |= mask;
+            if(flags & (GPIO_SLOWEST | GPIO_SLOW))
+                cfg->srcon1 |= mask;
+            continue;
+        }
+        if(flags & GPIO_PULLUP)
+            cfg->pullUp |= mask;
+        else if(flags & GPIO_PULLDOWN)
+            cfg->pullDown |= mask;
+        if(flags & GPIO_IRQ)
+            cfg->irq |= mask;
+    }
+
+    /*Functions are routed before any pin is driven, IOL1WAY may only allow this one unlock*/
+    if(remap){
+        SYS_Unlock(SYS_UNLOCK_IO);
+        for(size_t i = 0; i < count; i++){
+            if(table[i].ppsRegister != NULL)
+                *table[i].ppsRegister = table[i].ppsFunction;
+        }
+        SYS_Lock();
+    }
+
+    for(GPIO_Port port = 0; port < GPIO_NUMBER_OF_PORTS; port++){
+        GPIO_PortConfig *cfg = &ports[port];
+        uint32_t digital = cfg->used & ~cfg->analog;
+
+        if(cfg->used == 0)
+            continue;
+        GPIO_PORT(port)->lat.set = cfg->high;
+        GPIO_PORT(port)->lat.clr = cfg->output & ~cfg->high;
+        GPIO_PORT(port)->odc.set = cfg->openDrain;
+        GPIO_PORT(port)->odc.clr = cfg->used & ~cfg->openDrain;
+        GPIO_PORT(port)->srcon0.set = cfg->srcon0;
+        GPIO_PORT(port)->srcon0.clr = cfg->used & ~cfg->srcon0;
+        GPIO_PORT(port)->srcon1.set = cfg->srcon1;
+        GPIO_PORT(port)->srcon1.clr = cfg->used & ~cfg->srcon1;
+        GPIO_PORT(port)->cnpu.set = cfg->pullUp;
+        GPIO_PORT(port)->cnpu.clr = cfg->used & ~cfg->pullUp;
+        GPIO_PORT(port)->cnpd.set = cfg->pullDown;
+        GPIO_PORT(port)->cnpd.clr = cfg->used & ~cfg->pullDown;
+        GPIO_PORT(port)->cnen.set = cfg->irq;
+        GPIO_PORT(port)->cnen.clr = cfg->used & ~cfg->irq;
+        if(cfg->irq)
+            GPIO_PORT(port)->cncon.set = _CNCONA_ON_MASK;
+        GPIO_PORT(port)->ansel.set = cfg->analog;
+        GPIO_PORT(port)->ansel.clr = digital;
+        /*Direction last so no pin drives a stale level or floats while pulls are still off*/
+        GPIO_PORT(port)->tris.set = cfg->used & ~cfg->output;
+        GPIO_PORT(port)->tris.clr = cfg->output;
+    }
+}
+
 HAL_WEAK_FUNCTION void    GPIO_pin_interrupt_callback     (GPIO_PinMap pin)
 {
     (void)pin;
@@ -145,5 +314,49 @@ void GPIO_interrupt_handler(GPIO_Port port)
     GPIO_PORT(port)->port.reg;
 
     EVIC_channel_pending_clear(GPIO_PORT_IRQ_CHANNEL(port));
+    for(int i = 0; i < GPIO_CALLBACKS_PER_PORT; i++){
+        GPIO_CALLBACK_OBJECT *obj = &gpioCallbacks[port][i];
+        if(obj->callback != NULL)
+            obj->callback(status | obj->pin, obj->context);
+    }
     GPIO_pin_interrupt_callback(status | (port << GPIO_PORT_SHIFT));
 }
+
+int GPIO_callback_register(GPIO_Port port, GPIO_Callback callback, uintptr_t context)
+{
+    GPIO_CALLBACK_OBJECT *slot = NULL;
+
+    uint32_t status = EVIC_disable_interrupts();
+    for(int i = 0; i < GPIO_CALLBACKS_PER_PORT; i++){
+        GPIO_CALLBACK_OBJECT *obj = &gpioCallbacks[port][i];
+        if(obj->callback == callback && obj->context == context){
+            EVIC_restore_interrupts(status);
+            return 0;
+        }
+        if(obj->callback == NULL && slot == NULL)
+            slot = obj;
+    }
+    if(slot != NULL){
+        slot->pin = port << GPIO_PORT_SHIFT;
+        slot->context = context;
+        slot->callback = callback;
+    }
+    EVIC_restore_interrupts(status);
+    return slot != NULL ? 0 : -1;
+}
+
+void GPIO_callback_unregister(GPIO_Port port, GPIO_Callback callback, uintptr_t context)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    for(int i = 0; i < GPIO_CALLBACKS_PER_PORT; i++){
+        GPIO_CALLBACK_OBJECT *obj = &gpioCallbacks[port][i];
+        if(obj->callback == callback && obj->context == context)
+            obj->callback = NULL;
+    }
+    EVIC_restore_interrupts(status);
+}
+
+GPIO_Descriptor GPIO_get_descriptor(GPIO_Port port)
+{
+    return GPIO_PORT(port);
+}
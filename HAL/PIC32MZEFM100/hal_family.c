@@ -0,0 +1,63 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_family.h"
+/**********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+const EVIC_CHANNEL halTmrIrqChannels[TMR_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_TIMER_2,
+        EVIC_CHANNEL_TIMER_3,
+        EVIC_CHANNEL_TIMER_4,
+        EVIC_CHANNEL_TIMER_5,
+        EVIC_CHANNEL_TIMER_6,
+        EVIC_CHANNEL_TIMER_7,
+        EVIC_CHANNEL_TIMER_8,
+        EVIC_CHANNEL_TIMER_9,
+};
+const EVIC_CHANNEL halOcIrqChannels[OC_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_OUTPUT_COMPARE_1,
+        EVIC_CHANNEL_OUTPUT_COMPARE_2,
+        EVIC_CHANNEL_OUTPUT_COMPARE_3,
+        EVIC_CHANNEL_OUTPUT_COMPARE_4,
+        EVIC_CHANNEL_OUTPUT_COMPARE_5,
+        EVIC_CHANNEL_OUTPUT_COMPARE_6,
+        EVIC_CHANNEL_OUTPUT_COMPARE_7,
+        EVIC_CHANNEL_OUTPUT_COMPARE_8,
+        EVIC_CHANNEL_OUTPUT_COMPARE_9,
+};
+const EVIC_CHANNEL halIcIrqChannels[IC_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_INPUT_CAPTURE_1,
+        EVIC_CHANNEL_INPUT_CAPTURE_2,
+        EVIC_CHANNEL_INPUT_CAPTURE_3,
+        EVIC_CHANNEL_INPUT_CAPTURE_4,
+        EVIC_CHANNEL_INPUT_CAPTURE_5,
+        EVIC_CHANNEL_INPUT_CAPTURE_6,
+        EVIC_CHANNEL_INPUT_CAPTURE_7,
+        EVIC_CHANNEL_INPUT_CAPTURE_8,
+        EVIC_CHANNEL_INPUT_CAPTURE_9,
+};
+const EVIC_CHANNEL halUartIrqBase[UART_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_UART1_FAULT,
+        EVIC_CHANNEL_UART2_FAULT,
+        EVIC_CHANNEL_UART3_FAULT,
+        EVIC_CHANNEL_UART4_FAULT,
+        EVIC_CHANNEL_UART5_FAULT,
+        EVIC_CHANNEL_UART6_FAULT,
+};
+const EVIC_CHANNEL halSpiIrqBase[SPI_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_SPI1_FAULT,
+        EVIC_CHANNEL_SPI2_FAULT,
+        EVIC_CHANNEL_SPI3_FAULT,
+        EVIC_CHANNEL_SPI4_FAULT,
+        EVIC_CHANNEL_SPI5_FAULT,
+        EVIC_CHANNEL_SPI6_FAULT,
+};
+const EVIC_CHANNEL halI2cIrqBase[I2C_NUMBER_OF_CHANNELS]={
+        EVIC_CHANNEL_I2C1_BUS,
+        EVIC_CHANNEL_I2C2_BUS,
+        EVIC_CHANNEL_I2C3_BUS,
+        EVIC_CHANNEL_I2C4_BUS,
+        EVIC_CHANNEL_I2C5_BUS,
+};
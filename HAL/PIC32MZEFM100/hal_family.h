@@ -0,0 +1,68 @@
+/**
+ * @file hal_family.h
+ * @brief PIC32MZ EF family layer. Channel counts, register descriptor lookups and interrupt maps for the drivers in
+ * common/, which are built unchanged for every family.
+ */
+
+#ifndef HAL_FAMILY_H
+#define HAL_FAMILY_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "pic32mz_registers.h"
+#include "evic.h"
+#include <xc.h>
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+/*RX, TX and fault sources of UART and SPI have a vector each*/
+#define HAL_SHARED_PERIPHERAL_VECTORS       (0)
+/*DCHxSSIZ, DCHxDSIZ and DCHxCSIZ are 16 bit*/
+#define DMA_MAX_TRANSFER_SIZE               (65535)
+
+#define DMA_NUMBER_OF_CHANNELS              (8)
+#define TMR_NUMBER_OF_CHANNELS              (8)
+#define OC_NUMBER_OF_CHANNELS               (9)
+#define IC_NUMBER_OF_CHANNELS               (9)
+#define UART_NUMBER_OF_CHANNELS             (6)
+#define SPI_NUMBER_OF_CHANNELS              (6)
+#define I2C_NUMBER_OF_CHANNELS              (5)
+/**********************************************************************
+* Preprocessor Macros
+**********************************************************************/
+#define DMA_DESCRIPTOR(channel)             ((DMA_Descriptor)(((uint8_t*)(&DCH0CON)) + 0xC0*(channel)))
+#define TMR_DESCRIPTOR(channel)             ((TMR_Descriptor)(((uint8_t*)(_TMR2_BASE_ADDRESS)) + 0x200*(channel)))
+#define OC_DESCRIPTOR(channel)              ((OC_Descriptor)(((uint8_t*)(_OCMP1_BASE_ADDRESS)) + 0x200*(channel)))
+#define IC_DESCRIPTOR(channel)              ((IC_Descriptor)(((uint8_t*)(_ICAP1_BASE_ADDRESS)) + 0x200*(channel)))
+#define UART_DESCRIPTOR(channel)            ((UART_Descriptor)(((uint8_t*)(_UART1_BASE_ADDRESS)) + 0x200*(channel)))
+#define SPI_DESCRIPTOR(channel)             ((SPI_Descriptor)(((uint8_t*)(_SPI1_BASE_ADDRESS)) + 0x200*(channel)))
+#define I2C_DESCRIPTOR(channel)             ((I2C_Descriptor)(((uint8_t*)(_I2C1_BASE_ADDRESS)) + 0x200*(channel)))
+#define I2C_CHANNEL_PRESENT(channel)        ((channel) < I2C_NUMBER_OF_CHANNELS)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+/**********************************************************************
+* Variable Declarations
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+extern const EVIC_CHANNEL halTmrIrqChannels[TMR_NUMBER_OF_CHANNELS];
+extern const EVIC_CHANNEL halOcIrqChannels[OC_NUMBER_OF_CHANNELS];
+extern const EVIC_CHANNEL halIcIrqChannels[IC_NUMBER_OF_CHANNELS];
+/*Fault (error) interrupt of each channel, RX and TX are the next two*/
+extern const EVIC_CHANNEL halUartIrqBase[UART_NUMBER_OF_CHANNELS];
+extern const EVIC_CHANNEL halSpiIrqBase[SPI_NUMBER_OF_CHANNELS];
+/*Bus collision interrupt of each channel, slave and master are the next two*/
+extern const EVIC_CHANNEL halI2cIrqBase[I2C_NUMBER_OF_CHANNELS];
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //HAL_FAMILY_H
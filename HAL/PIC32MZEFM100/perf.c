@@ -0,0 +1,81 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "perf.h"
+#include <xc.h>
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+/*CP0 register 25, control and count registers alternate per counter*/
+#define PERF_CP0_REGISTER                   (25)
+#define PERF_CTL_COUNT_ALL_MODES            (0x0F)
+#define PERF_CTL_EVENT_POSITION             (5)
+#define PERF_CTL_EVENT_MASK                 (0x3F)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+/*The core timer runs at SYSCLK/2*/
+#define PERF_CYCLES()                       (_CP0_GET_COUNT() << 1)
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static uint8_t perfEvents[SYS_PERF_COUNTERS] = {SYS_PERF_NONE, SYS_PERF_NONE};
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+bool            SYS_perf_available      (void)
+{
+    return true;
+}
+
+int             SYS_perf_counter_set    (uint32_t counter, uint32_t event)
+{
+    uint32_t control = event == SYS_PERF_NONE ? 0 :
+            ((event & PERF_CTL_EVENT_MASK) << PERF_CTL_EVENT_POSITION) | PERF_CTL_COUNT_ALL_MODES;
+
+    if(counter == SYS_PERF_COUNTER_0)
+        _mtc0(PERF_CP0_REGISTER, 0, control);
+    else if(counter == SYS_PERF_COUNTER_1)
+        _mtc0(PERF_CP0_REGISTER, 2, control);
+    else
+        return -1;
+    _ehb();
+    perfEvents[counter] = event;
+    return 0;
+}
+
+uint32_t        SYS_perf_counter_get    (uint32_t counter)
+{
+    if(counter == SYS_PERF_COUNTER_0)
+        return _mfc0(PERF_CP0_REGISTER, 1);
+    if(counter == SYS_PERF_COUNTER_1)
+        return _mfc0(PERF_CP0_REGISTER, 3);
+    return 0;
+}
+
+uint32_t        SYS_perf_cycles_get     (void)
+{
+    return PERF_CYCLES();
+}
+
+uint32_t        SYS_perf_counter_event_get(uint32_t counter)
+{
+    return counter < SYS_PERF_COUNTERS ? perfEvents[counter] : SYS_PERF_NONE;
+}
+
+/*Events are read outside of the cycle window so both ends cost the same*/
+void            SYS_perf_sample         (SYS_Perf_Sample *sample)
+{
+    sample->events[SYS_PERF_COUNTER_0] = _mfc0(PERF_CP0_REGISTER, 1);
+    sample->events[SYS_PERF_COUNTER_1] = _mfc0(PERF_CP0_REGISTER, 3);
+    sample->cycles = PERF_CYCLES();
+}
@@ -81,6 +81,11 @@ typedef struct{
     struct MemRegister ocxrs;
 }volatile * const OC_Descriptor;
 
+typedef struct{
+    struct MemRegister icxcon;
+    struct MemRegister icxbuf;
+}volatile * const IC_Descriptor;
+
 typedef struct{
     struct MemRegister pbxdiv;
 }volatile * const PBCLK_Descriptor;
@@ -92,6 +97,18 @@ typedef struct{
     struct MemRegister urxreg;
     struct MemRegister ubrg;
 }volatile * const UART_Descriptor;
+
+typedef struct{
+    struct MemRegister i2ccon;
+    struct MemRegister i2cstat;
+    struct MemRegister i2cadd;
+    struct MemRegister i2cmsk;
+    struct MemRegister i2cbrg;
+    struct MemRegister i2ctrn;
+    struct MemRegister i2crcv;
+}volatile * const I2C_Descriptor;
+
+GPIO_Descriptor GPIO_get_descriptor(uint32_t port);
 #ifdef	__cplusplus
 }
 #endif
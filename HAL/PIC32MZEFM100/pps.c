@@ -2,9 +2,127 @@
 // Created by bruno on 02/02/23.
 //
 
+/**********************************************************************
+* Includes
+**********************************************************************/
 #include "pps.h"
+#include <xc.h>
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+#define PPS_PIN_INPUT_MASK              (0x0F)
+#define PPS_PIN_GROUP_POSITION          (4)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+/*RPxnR sit one word per pin, 0x40 bytes per port, RPA14R being the first one*/
+#define PPS_OUTPUT_REGISTER(port, index) ((volatile uint32_t*)&RPA14R + ((port) << 4) + (index) - 14)
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
 
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+/*Group of each RPn pin in the upper nibble, 0 when the pin is not remappable, its input selection code in the lower*/
+static const uint8_t ppsPins[PPS_NUMBER_OF_PORTS][16] = {
+        [GPIO_PORT_A] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1D, 0x2D},
+        [GPIO_PORT_B] = {0x35, 0x25, 0x47, 0x28, 0x00, 0x18, 0x45, 0x37, 0x32, 0x15, 0x16, 0x00, 0x00, 0x00, 0x42, 0x33},
+        [GPIO_PORT_C] = {0x00, 0x1A, 0x4C, 0x3C, 0x2A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x27, 0x17, 0x00},
+        [GPIO_PORT_D] = {0x43, 0x40, 0x10, 0x20, 0x34, 0x46, 0x1E, 0x2E, 0x00, 0x30, 0x13, 0x23, 0x3A, 0x00, 0x1B, 0x2B},
+        [GPIO_PORT_E] = {0x00, 0x00, 0x00, 0x36, 0x00, 0x26, 0x00, 0x00, 0x4D, 0x3D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+        [GPIO_PORT_F] = {0x24, 0x14, 0x4B, 0x48, 0x12, 0x22, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x00, 0x39, 0x49, 0x00, 0x00},
+        [GPIO_PORT_G] = {0x2C, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x31, 0x21, 0x11, 0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+};
+static volatile uint32_t * const ppsInputRegisters[PPS_NUMBER_OF_INPUTS] = {
+        [PPS_INPUT_INDEX(PPS_IN_INT3)]     = PPS_INPUT_REG_INT3,
+        [PPS_INPUT_INDEX(PPS_IN_T2CK)]     = PPS_INPUT_REG_T2CK,
+        [PPS_INPUT_INDEX(PPS_IN_T6CK)]     = PPS_INPUT_REG_T6CK,
+        [PPS_INPUT_INDEX(PPS_IN_IC3)]      = PPS_INPUT_REG_IC3,
+        [PPS_INPUT_INDEX(PPS_IN_IC7)]      = PPS_INPUT_REG_IC7,
+        [PPS_INPUT_INDEX(PPS_IN_U1RX)]     = PPS_INPUT_REG_U1RX,
+        [PPS_INPUT_INDEX(PPS_IN_U2CTS)]    = PPS_INPUT_REG_U2CTS,
+        [PPS_INPUT_INDEX(PPS_IN_U5RX)]     = PPS_INPUT_REG_U5RX,
+        [PPS_INPUT_INDEX(PPS_IN_U6CTS)]    = PPS_INPUT_REG_U6CTS,
+        [PPS_INPUT_INDEX(PPS_IN_SDI1)]     = PPS_INPUT_REG_SDI1,
+        [PPS_INPUT_INDEX(PPS_IN_SDI3)]     = PPS_INPUT_REG_SDI3,
+        [PPS_INPUT_INDEX(PPS_IN_SDI5)]     = PPS_INPUT_REG_SDI5,
+        [PPS_INPUT_INDEX(PPS_IN_SS6)]      = PPS_INPUT_REG_SS6,
+        [PPS_INPUT_INDEX(PPS_IN_REFCLKI1)] = PPS_INPUT_REG_REFCLKI1,
+        [PPS_INPUT_INDEX(PPS_IN_INT4)]     = PPS_INPUT_REG_INT4,
+        [PPS_INPUT_INDEX(PPS_IN_T5CK)]     = PPS_INPUT_REG_T5CK,
+        [PPS_INPUT_INDEX(PPS_IN_T7CK)]     = PPS_INPUT_REG_T7CK,
+        [PPS_INPUT_INDEX(PPS_IN_IC4)]      = PPS_INPUT_REG_IC4,
+        [PPS_INPUT_INDEX(PPS_IN_IC8)]      = PPS_INPUT_REG_IC8,
+        [PPS_INPUT_INDEX(PPS_IN_U3RX)]     = PPS_INPUT_REG_U3RX,
+        [PPS_INPUT_INDEX(PPS_IN_U4CTS)]    = PPS_INPUT_REG_U4CTS,
+        [PPS_INPUT_INDEX(PPS_IN_SDI2)]     = PPS_INPUT_REG_SDI2,
+        [PPS_INPUT_INDEX(PPS_IN_SDI4)]     = PPS_INPUT_REG_SDI4,
+        [PPS_INPUT_INDEX(PPS_IN_C1RX)]     = PPS_INPUT_REG_C1RX,
+        [PPS_INPUT_INDEX(PPS_IN_REFCLKI4)] = PPS_INPUT_REG_REFCLKI4,
+        [PPS_INPUT_INDEX(PPS_IN_INT2)]     = PPS_INPUT_REG_INT2,
+        [PPS_INPUT_INDEX(PPS_IN_T3CK)]     = PPS_INPUT_REG_T3CK,
+        [PPS_INPUT_INDEX(PPS_IN_T8CK)]     = PPS_INPUT_REG_T8CK,
+        [PPS_INPUT_INDEX(PPS_IN_IC2)]      = PPS_INPUT_REG_IC2,
+        [PPS_INPUT_INDEX(PPS_IN_IC5)]      = PPS_INPUT_REG_IC5,
+        [PPS_INPUT_INDEX(PPS_IN_IC9)]      = PPS_INPUT_REG_IC9,
+        [PPS_INPUT_INDEX(PPS_IN_U1CTS)]    = PPS_INPUT_REG_U1CTS,
+        [PPS_INPUT_INDEX(PPS_IN_U2RX)]     = PPS_INPUT_REG_U2RX,
+        [PPS_INPUT_INDEX(PPS_IN_U5CTS)]    = PPS_INPUT_REG_U5CTS,
+        [PPS_INPUT_INDEX(PPS_IN_SS1)]      = PPS_INPUT_REG_SS1,
+        [PPS_INPUT_INDEX(PPS_IN_SS3)]      = PPS_INPUT_REG_SS3,
+        [PPS_INPUT_INDEX(PPS_IN_SS4)]      = PPS_INPUT_REG_SS4,
+        [PPS_INPUT_INDEX(PPS_IN_SS5)]      = PPS_INPUT_REG_SS5,
+        [PPS_INPUT_INDEX(PPS_IN_C2RX)]     = PPS_INPUT_REG_C2RX,
+        [PPS_INPUT_INDEX(PPS_IN_INT1)]     = PPS_INPUT_REG_INT1,
+        [PPS_INPUT_INDEX(PPS_IN_T4CK)]     = PPS_INPUT_REG_T4CK,
+        [PPS_INPUT_INDEX(PPS_IN_T9CK)]     = PPS_INPUT_REG_T9CK,
+        [PPS_INPUT_INDEX(PPS_IN_IC1)]      = PPS_INPUT_REG_IC1,
+        [PPS_INPUT_INDEX(PPS_IN_IC6)]      = PPS_INPUT_REG_IC6,
+        [PPS_INPUT_INDEX(PPS_IN_U3CTS)]    = PPS_INPUT_REG_U3CTS,
+        [PPS_INPUT_INDEX(PPS_IN_U4RX)]     = PPS_INPUT_REG_U4RX,
+        [PPS_INPUT_INDEX(PPS_IN_U6RX)]     = PPS_INPUT_REG_U6RX,
+        [PPS_INPUT_INDEX(PPS_IN_SS2)]      = PPS_INPUT_REG_SS2,
+        [PPS_INPUT_INDEX(PPS_IN_SDI6)]     = PPS_INPUT_REG_SDI6,
+        [PPS_INPUT_INDEX(PPS_IN_OCFA)]     = PPS_INPUT_REG_OCFA,
+        [PPS_INPUT_INDEX(PPS_IN_REFCLKI3)] = PPS_INPUT_REG_REFCLKI3,
+};
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
 void PPS_pin_mapping(PPS_Register reg , PPS_AlternateFunction af)
 {
     *reg = af;
-}
\ No newline at end of file
+}
+
+int  PPS_map(uint32_t function, GPIO_PinMap pin)
+{
+    uint32_t port = PPS_PIN_PORT(pin);
+
+    if(port >= PPS_NUMBER_OF_PORTS || !PPS_PIN_SINGLE(pin))
+        return -1;
+
+    uint32_t index = __builtin_ctz(pin & GPIO_PIN_MASK);
+    uint32_t entry = ppsPins[port][index];
+    uint32_t group = entry >> PPS_PIN_GROUP_POSITION;
+
+    if(group == 0)
+        return -1;
+
+    if(PPS_IS_OUTPUT(function)){
+        uint32_t code = PPS_OUTPUT_CODE(function, group);
+        if(code == 0)
+            return -1;
+        *PPS_OUTPUT_REGISTER(port, index) = code;
+    }
+    else{
+        if(PPS_INPUT_GROUP(function) != group || PPS_INPUT_INDEX(function) >= PPS_NUMBER_OF_INPUTS)
+            return -1;
+        *ppsInputRegisters[PPS_INPUT_INDEX(function)] = entry & PPS_PIN_INPUT_MASK;
+    }
+    return 0;
+}
@@ -4,34 +4,104 @@
 #include "system.h"
 #include <xc.h>
 #include "pic32mz_registers.h"
+#include "evic.h"
+#include "hal_delay.h"
+#include "hal_time.h"
+#include "dma.h"
+#include "hal_family.h"
 /**********************************************************************
 * Module Preprocessor Constants
 **********************************************************************/
 #define SYS_PBCLK_BASE                          ((uint8_t*)&PB1DIV)
+#ifndef SYS_POSC_FREQUENCY
+#define SYS_POSC_FREQUENCY                      (24000000UL)
+#endif
+#define SYS_FRC_FREQUENCY                       (8000000UL)
+#define SYS_CLOCK_MAX_FREQUENCY                 (200000000UL)
+#define SYS_PLL_INPUT_MIN                       (5000000UL)
+#define SYS_PLL_INPUT_MAX                       (64000000UL)
+#define SYS_PLL_VCO_MIN                         (350000000ULL)
+#define SYS_PLL_VCO_MAX                         (700000000ULL)
+#define SYS_PLL_MULT_MAX                        (128)
+#define SYS_PLL_IDIV_MAX                        (8)
+#define SYS_OSC_FRC                             (0)
+#define SYS_OSC_SPLL                            (1)
 /**********************************************************************
 * Module Preprocessor Macros
 **********************************************************************/
 #define SYS_PBCLK(channel)                      ((PBCLK_Descriptor)(SYS_PBCLK_BASE + channel*0x10))
+#define SYS_PMD(reg)                            ((MemRegister)(((uint8_t*)&PMD1) + ((reg) - 1)*0x10))
 /**********************************************************************
 * Module Typedefs
 **********************************************************************/
+typedef struct{
+    SYS_Clock_Notifier  notifier;
+    uintptr_t           context;
+}SYS_Clock_Listener;
 
+typedef struct{
+    uint16_t    first;
+    uint16_t    count;
+}SYS_Pmd_Range;
 /*********************************************************************
 * Module Variable Definitions
 **********************************************************************/
-
+static uint32_t sysClockFrequency = HAL_SYSTEM_CLOCK;
+static SYS_Clock_Listener sysClockListeners[SYS_CLOCK_MAX_NOTIFIERS];
+static uint8_t pmdCounts[SYS_PMD_NUMBER_OF_MODULES];
+static uint32_t powerInhibit[SYS_POWER_MODES];
+static SYS_Power_Stats powerStats;
+static uint64_t powerStatsStart;
+static uint8_t pmdBusCounts[SYS_PERIPHERAL_CLOCK_8 + 1];
+/*Modules with a driver in the HAL, gated by SYS_initialize until the driver acquires them*/
+static const SYS_Pmd_Range pmdDriverModules[] = {
+    {SYS_PMD_ADC, 1},
+    {SYS_PMD_IC(0), IC_NUMBER_OF_CHANNELS},
+    {SYS_PMD_OC(0), OC_NUMBER_OF_CHANNELS},
+    {SYS_PMD_TMR(0), TMR_NUMBER_OF_CHANNELS},
+    {SYS_PMD_UART(0), UART_NUMBER_OF_CHANNELS},
+    {SYS_PMD_SPI(0), SPI_NUMBER_OF_CHANNELS},
+    {SYS_PMD_I2C(0), I2C_NUMBER_OF_CHANNELS},
+    {SYS_PMD_DMA, 1},
+};
+/*Upper bound of the PLL input frequency for each PLLRANGE setting, starting at 1*/
+static const uint32_t pllRangeTable[] = {
+    10000000, 16000000, 26000000, 42000000, 64000000
+};
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
+static void SYS_oscillator_switch(uint32_t source);
+static uint32_t SYS_flash_wait_states(uint32_t frequency);
+static void SYS_pmd_power(uint32_t module, bool on);
+static void SYS_pmd_write(uint32_t reg, uint32_t mask, bool on);
+static void SYS_pbclk_write(uint32_t bus, bool on);
+static uint32_t SYS_power_enter(uint32_t mode);
+static int SYS_pmd_bus(uint32_t module);
 
 /**********************************************************************
 * Function Definitions
 **********************************************************************/
 void SYS_initialize()
 {
+    uint32_t gated[SYS_PMD_NUMBER_OF_MODULES >> 5] = {0};
+
     PRECONbits.PREFEN = 3;
-    PRECONbits.PFMWS = 3;
     CFGCONbits.ECCCON = 3;
+    SYS_flash_wait_states_update();
+
+    /*Every module comes out of reset clocked, the ones the HAL drives are gated until first acquired*/
+    for(size_t i = 0; i < sizeof(pmdDriverModules) / sizeof(pmdDriverModules[0]); i++){
+        const SYS_Pmd_Range *range = &pmdDriverModules[i];
+        for(uint32_t module = range->first; module < range->first + range->count; module++){
+            if(pmdCounts[module] == 0)
+                gated[module >> 5] |= 1u << (module & 31);
+        }
+    }
+    for(uint32_t reg = 1; reg < sizeof(gated) / sizeof(gated[0]); reg++){
+        if(gated[reg] != 0)
+            SYS_pmd_write(reg, gated[reg], false);
+    }
 }
 
 void SYS_Unlock(uint32_t flags)
@@ -59,7 +129,7 @@ void SYS_peripheral_clock_config(uint32_t clockChannel, uint32_t flags)
     
     while(!(SYS_PBCLK(clockChannel)->pbxdiv.reg & _PB1DIV_PBDIVRDY_POSITION));
 
-    if((HAL_SYSTEM_CLOCK > 100000000UL) &&
+    if((sysClockFrequency > 100000000UL) &&
             ((clockChannel != SYS_PERIPHERAL_CLOCK_4) && (clockChannel != SYS_PERIPHERAL_CLOCK_7)) &&
             ((flags & 127) & SYS_PBCLK_DIVISOR_1))
         return;
@@ -72,7 +142,7 @@ uint32_t    SYS_peripheral_clock_frequency_get(uint32_t clockChannel)
 {
     if(!(SYS_PBCLK(clockChannel)->pbxdiv.reg & _PB2DIV_ON_MASK))
         return 0;
-    return HAL_SYSTEM_CLOCK / ((SYS_PBCLK(clockChannel)->pbxdiv.reg & _PB2DIV_PBDIV_MASK)+1);
+    return sysClockFrequency / ((SYS_PBCLK(clockChannel)->pbxdiv.reg & _PB2DIV_PBDIV_MASK)+1);
 }
 
 void SYS_soft_reset(uint32_t val)
@@ -91,4 +161,304 @@ void SYS_soft_reset(uint32_t val)
     (void)dummy;
 /* prevent any unwanted code execution until reset occurs*/
     while(1);
-}
\ No newline at end of file
+}
+
+uint32_t    SYS_clock_frequency_get(void)
+{
+    return sysClockFrequency;
+}
+
+/*Reprograms SPLL for the closest achievable frequency and returns it, 0 when nothing fits.
+ The PLL can only be reconfigured while it is not the clock source, the core runs from FRC meanwhile.*/
+uint32_t    SYS_clock_set(uint32_t frequency)
+{
+    static const uint32_t odivTable[] = { 2, 4, 8, 16, 32 };
+    bool frc = SPLLCONbits.PLLICLK;
+    uint32_t input = frc ? SYS_FRC_FREQUENCY : SYS_POSC_FREQUENCY;
+    uint32_t best = 0, bestError = UINT32_MAX;
+    uint32_t bestIdiv = 0, bestMult = 0, bestOdiv = 0;
+
+    if(frequency == 0 || frequency > SYS_CLOCK_MAX_FREQUENCY)
+        return 0;
+
+    for(uint32_t idiv = 1; idiv <= SYS_PLL_IDIV_MAX; idiv++){
+        uint32_t pllIn = input / idiv;
+        if(pllIn < SYS_PLL_INPUT_MIN || pllIn > SYS_PLL_INPUT_MAX)
+            continue;
+        for(uint32_t i = 0; i < sizeof(odivTable) / sizeof(odivTable[0]); i++){
+            uint64_t vco = (uint64_t)frequency * odivTable[i];
+            uint32_t mult = (vco + pllIn / 2) / pllIn;
+            if(mult == 0 || mult > SYS_PLL_MULT_MAX)
+                continue;
+            vco = (uint64_t)pllIn * mult;
+            if(vco < SYS_PLL_VCO_MIN || vco > SYS_PLL_VCO_MAX)
+                continue;
+            uint32_t achieved = vco / odivTable[i];
+            uint32_t error = achieved > frequency ? achieved - frequency : frequency - achieved;
+            if(achieved <= SYS_CLOCK_MAX_FREQUENCY && error < bestError){
+                best = achieved;
+                bestError = error;
+                bestIdiv = idiv;
+                bestMult = mult;
+                bestOdiv = i + 1;
+            }
+        }
+    }
+    if(best == 0)
+        return 0;
+
+    uint32_t range = 1;
+    while(range < sizeof(pllRangeTable) / sizeof(pllRangeTable[0]) && input / bestIdiv > pllRangeTable[range - 1])
+        range++;
+
+    uint32_t status = EVIC_disable_interrupts();
+    uint32_t old = sysClockFrequency;
+
+    /*Flash needs the extra wait states before the clock goes up and keeps them until it is down*/
+    if(best > old)
+        PRECONbits.PFMWS = SYS_flash_wait_states(best);
+
+    SYS_oscillator_switch(SYS_OSC_FRC);
+    /*SPLLCON is write protected like OSCCON, the switch above has locked the system again*/
+    SYSKEY = 0x00000000;
+    SYSKEY = 0xAA996655;
+    SYSKEY = 0x556699AA;
+    SPLLCON = (bestOdiv << _SPLLCON_PLLODIV_POSITION) | ((bestMult - 1) << _SPLLCON_PLLMULT_POSITION) |
+              ((bestIdiv - 1) << _SPLLCON_PLLIDIV_POSITION) | ((uint32_t)frc << _SPLLCON_PLLICLK_POSITION) |
+              (range << _SPLLCON_PLLRANGE_POSITION);
+    SYSKEY = 0x00000000;
+    SYS_oscillator_switch(SYS_OSC_SPLL);
+
+    if(best < old)
+        PRECONbits.PFMWS = SYS_flash_wait_states(best);
+
+    sysClockFrequency = best;
+    HAL_delay_clock_update(best);
+    for(uint32_t i = 0; i < SYS_CLOCK_MAX_NOTIFIERS; i++){
+        if(sysClockListeners[i].notifier != NULL)
+            sysClockListeners[i].notifier(old, best, sysClockListeners[i].context);
+    }
+    EVIC_restore_interrupts(status);
+    return best;
+}
+
+/*Fewest flash wait states that are safe at the current SYSCLK*/
+void        SYS_flash_wait_states_update(void)
+{
+    PRECONbits.PFMWS = SYS_flash_wait_states(sysClockFrequency);
+}
+
+bool        SYS_clock_notifier_register(SYS_Clock_Notifier notifier, uintptr_t context)
+{
+    for(uint32_t i = 0; i < SYS_CLOCK_MAX_NOTIFIERS; i++){
+        if(sysClockListeners[i].notifier == NULL){
+            sysClockListeners[i].context = context;
+            sysClockListeners[i].notifier = notifier;
+            return true;
+        }
+    }
+    return false;
+}
+
+void        SYS_clock_notifier_unregister(SYS_Clock_Notifier notifier, uintptr_t context)
+{
+    for(uint32_t i = 0; i < SYS_CLOCK_MAX_NOTIFIERS; i++){
+        if(sysClockListeners[i].notifier == notifier && sysClockListeners[i].context == context)
+            sysClockListeners[i].notifier = NULL;
+    }
+}
+
+void        SYS_pmd_acquire(uint32_t module)
+{
+    if(module >= SYS_PMD_NUMBER_OF_MODULES)
+        return;
+    uint32_t status = EVIC_disable_interrupts();
+    if(pmdCounts[module]++ == 0)
+        SYS_pmd_power(module, true);
+    EVIC_restore_interrupts(status);
+}
+
+void        SYS_pmd_release(uint32_t module)
+{
+    if(module >= SYS_PMD_NUMBER_OF_MODULES)
+        return;
+    uint32_t status = EVIC_disable_interrupts();
+    if(pmdCounts[module] != 0 && --pmdCounts[module] == 0)
+        SYS_pmd_power(module, false);
+    EVIC_restore_interrupts(status);
+}
+
+uint32_t    SYS_pmd_count_get(uint32_t module)
+{
+    if(module >= SYS_PMD_NUMBER_OF_MODULES)
+        return 0;
+    return pmdCounts[module];
+}
+
+uint32_t    SYS_idle(void)
+{
+    return SYS_power_enter(SYS_POWER_IDLE);
+}
+
+uint32_t    SYS_sleep(void)
+{
+    return SYS_power_enter(DMA_is_active() ? SYS_POWER_IDLE : SYS_POWER_SLEEP);
+}
+
+void        SYS_power_inhibit(uint32_t mode)
+{
+    if(mode == SYS_POWER_RUN || mode >= SYS_POWER_MODES)
+        return;
+    uint32_t status = EVIC_disable_interrupts();
+    powerInhibit[mode]++;
+    EVIC_restore_interrupts(status);
+}
+
+void        SYS_power_allow(uint32_t mode)
+{
+    if(mode == SYS_POWER_RUN || mode >= SYS_POWER_MODES)
+        return;
+    uint32_t status = EVIC_disable_interrupts();
+    if(powerInhibit[mode] != 0)
+        powerInhibit[mode]--;
+    EVIC_restore_interrupts(status);
+}
+
+void        SYS_power_stats_get(SYS_Power_Stats *stats)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    *stats = powerStats;
+    stats->timeNs[SYS_POWER_RUN] = SYS_power_timestamp_get() - powerStatsStart -
+            powerStats.timeNs[SYS_POWER_IDLE] - powerStats.timeNs[SYS_POWER_SLEEP];
+    EVIC_restore_interrupts(status);
+}
+
+void        SYS_power_stats_reset(void)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    for(uint32_t i = 0; i < SYS_POWER_MODES; i++){
+        powerStats.timeNs[i] = 0;
+        powerStats.entries[i] = 0;
+    }
+    powerStatsStart = SYS_power_timestamp_get();
+    EVIC_restore_interrupts(status);
+}
+
+HAL_WEAK_FUNCTION uint64_t SYS_power_timestamp_get(void)
+{
+    return HAL_time_now_ns();
+}
+
+static void SYS_oscillator_switch(uint32_t source)
+{
+    SYSKEY = 0x00000000;
+    SYSKEY = 0xAA996655;
+    SYSKEY = 0x556699AA;
+    OSCCONbits.NOSC = source;
+    OSCCONSET = _OSCCON_OSWEN_MASK;
+    SYSKEY = 0x00000000;
+    /*OSWEN clears once the new source is running, for SPLL that includes the lock time*/
+    while(OSCCONbits.OSWEN);
+}
+
+/*Wait states from the ECC column of the datasheet, they are also safe with ECC disabled*/
+static uint32_t SYS_flash_wait_states(uint32_t frequency)
+{
+    if(frequency <= 60000000UL)
+        return 0;
+    if(frequency <= 120000000UL)
+        return 1;
+    return 2;
+}
+
+/*PMD bits reset the module while set, the bus only goes down after the last module on it was released*/
+static void SYS_pmd_power(uint32_t module, bool on)
+{
+    int bus = SYS_pmd_bus(module);
+
+    if(on && bus >= 0 && pmdBusCounts[bus]++ == 0 && !(SYS_PBCLK(bus)->pbxdiv.reg & _PB2DIV_ON_MASK)){
+        SYS_pbclk_write(bus, true);
+        while(!(SYS_PBCLK(bus)->pbxdiv.reg & _PB2DIV_PBDIVRDY_MASK));
+    }
+
+    SYS_pmd_write(module >> 5, 1u << (module & 31), on);
+
+    if(!on && bus >= 0 && pmdBusCounts[bus] != 0 && --pmdBusCounts[bus] == 0)
+        SYS_pbclk_write(bus, false);
+}
+
+/*PBxDIV is write protected as well*/
+static void SYS_pbclk_write(uint32_t bus, bool on)
+{
+    SYSKEY = 0x00000000;
+    SYSKEY = 0xAA996655;
+    SYSKEY = 0x556699AA;
+    if(on)
+        SYS_PBCLK(bus)->pbxdiv.set = _PB2DIV_ON_MASK;
+    else
+        SYS_PBCLK(bus)->pbxdiv.clr = _PB2DIV_ON_MASK;
+    SYSKEY = 0x00000000;
+}
+
+static void SYS_pmd_write(uint32_t reg, uint32_t mask, bool on)
+{
+    SYSKEY = 0x00000000;
+    SYSKEY = 0xAA996655;
+    SYSKEY = 0x556699AA;
+    CFGCONbits.PMDLOCK = 0;
+    if(on)
+        SYS_PMD(reg)->clr = mask;
+    else
+        SYS_PMD(reg)->set = mask;
+    CFGCONbits.PMDLOCK = 1;
+    SYSKEY = 0x00000000;
+}
+
+/*PBCLK bus of a module, -1 when it is on PBCLK1/system bus or shares its bus with always used modules*/
+static int SYS_pmd_bus(uint32_t module)
+{
+    switch(module >> 5){
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+            return SYS_PERIPHERAL_CLOCK_3;
+        case 5:
+            return (module & 31) < 24 ? SYS_PERIPHERAL_CLOCK_2 : SYS_PERIPHERAL_CLOCK_5;
+        default:
+            return -1;
+    }
+}
+
+/*An inhibited mode falls back to the next lighter one*/
+static uint32_t SYS_power_enter(uint32_t mode)
+{
+    if(mode == SYS_POWER_SLEEP && powerInhibit[SYS_POWER_SLEEP] != 0)
+        mode = SYS_POWER_IDLE;
+    if(mode == SYS_POWER_IDLE && powerInhibit[SYS_POWER_IDLE] != 0)
+        return SYS_POWER_RUN;
+
+    uint32_t source = OSCCONbits.COSC;
+    SYSKEY = 0x00000000;
+    SYSKEY = 0xAA996655;
+    SYSKEY = 0x556699AA;
+    if(mode == SYS_POWER_SLEEP)
+        OSCCONSET = _OSCCON_SLPEN_MASK;
+    else
+        OSCCONCLR = _OSCCON_SLPEN_MASK;
+    SYSKEY = 0x00000000;
+
+    uint64_t start = SYS_power_timestamp_get();
+    _wait();
+
+    /*The oscillator restarts on its own, wait for the PLL before anything depends on the clock*/
+    if(mode == SYS_POWER_SLEEP){
+        if(OSCCONbits.COSC != source)
+            SYS_oscillator_switch(source);
+        if(source == SYS_OSC_SPLL)
+            while(!CLKSTATbits.SPLLRDY);
+    }
+    powerStats.timeNs[mode] += SYS_power_timestamp_get() - start;
+    powerStats.entries[mode]++;
+    return mode;
+}
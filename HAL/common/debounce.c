@@ -0,0 +1,176 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "debounce.h"
+#include "gpio.h"
+#include "timer.h"
+#include "evic.h"
+#include "hal_delay.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+#define DEBOUNCE_PIN_UNUSED                 (GPIO_PIN_INVALID)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    GPIO_PinMap         pin;
+    uint32_t            ticks;
+    uint32_t            counter;
+    bool                state;
+    bool                sample;
+    DEBOUNCE_Callback   callback;
+    uintptr_t           context;
+}DEBOUNCE_Object;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static DEBOUNCE_Object debounceObjects[DEBOUNCE_MAX_PINS] = {
+        [0 ... DEBOUNCE_MAX_PINS - 1] = { .pin = DEBOUNCE_PIN_UNUSED }
+};
+static uint32_t tickChannel;
+static uint32_t tickPeriodUs;
+static uint32_t activePins;
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static void DEBOUNCE_change_notice(GPIO_PinMap pins, uintptr_t context);
+static void DEBOUNCE_tick(uint32_t channel, uintptr_t context);
+static DEBOUNCE_Object* DEBOUNCE_object_get(GPIO_PinMap pin);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         DEBOUNCE_initialize         (uint32_t tmrChannel, uint32_t tickUs)
+{
+    if(tickUs == 0)
+        return -1;
+
+    tickChannel = tmrChannel;
+    tickPeriodUs = tickUs;
+    activePins = 0;
+
+    TMR_initialize(tmrChannel, TMR_PRESCALER_256, 0);
+    TMR_frequency_set(tmrChannel, MICRO_SECONDS / tickUs);
+    TMR_callback_register(tmrChannel, DEBOUNCE_tick, 0);
+    return 0;
+}
+
+int         DEBOUNCE_pin_register       (GPIO_PinMap pin, uint32_t debounceMs, DEBOUNCE_Callback callback, uintptr_t context)
+{
+    DEBOUNCE_Object *obj = DEBOUNCE_object_get(DEBOUNCE_PIN_UNUSED);
+    if(obj == NULL || GPIO_callback_register(pin >> GPIO_PORT_SHIFT, DEBOUNCE_change_notice, 0) < 0)
+        return -1;
+
+    obj->ticks = (debounceMs * 1000) / tickPeriodUs;
+    if(obj->ticks == 0)
+        obj->ticks = 1;
+    obj->counter = 0;
+    obj->callback = callback;
+    obj->context = context;
+    obj->state = obj->sample = GPIO_pin_read(pin);
+    obj->pin = pin;
+
+    GPIO_pin_interrupt_set(pin, true);
+    return 0;
+}
+
+void        DEBOUNCE_pin_unregister     (GPIO_PinMap pin)
+{
+    DEBOUNCE_Object *obj = DEBOUNCE_object_get(pin);
+    if(obj == NULL)
+        return;
+
+    GPIO_pin_interrupt_set(pin, false);
+
+    uint32_t status = EVIC_disable_interrupts();
+    if(obj->counter != 0 && --activePins == 0){
+        TMR_interrupt_set(tickChannel, false);
+        TMR_stop(tickChannel);
+    }
+    obj->counter = 0;
+    obj->pin = DEBOUNCE_PIN_UNUSED;
+    EVIC_restore_interrupts(status);
+}
+
+bool        DEBOUNCE_pin_state_get      (GPIO_PinMap pin)
+{
+    DEBOUNCE_Object *obj = DEBOUNCE_object_get(pin);
+    if(obj == NULL)
+        return false;
+    return obj->state;
+}
+
+static void DEBOUNCE_change_notice(GPIO_PinMap pins, uintptr_t context)
+{
+    (void)context;
+    GPIO_Port port = pins & GPIO_PORT_MASK;
+
+    for(int i = 0; i < DEBOUNCE_MAX_PINS; i++){
+        DEBOUNCE_Object *obj = &debounceObjects[i];
+        if(obj->pin == DEBOUNCE_PIN_UNUSED || (obj->pin & GPIO_PORT_MASK) != port)
+            continue;
+        if((obj->pin & pins & GPIO_PIN_MASK) == 0 || obj->counter != 0)
+            continue;
+
+        /*Ignore every further edge until the debounce window expires*/
+        GPIO_pin_interrupt_set(obj->pin, false);
+        obj->sample = GPIO_pin_read(obj->pin);
+
+        uint32_t status = EVIC_disable_interrupts();
+        obj->counter = obj->ticks;
+        if(activePins++ == 0){
+            TMR_start(tickChannel);
+            TMR_interrupt_set(tickChannel, true);
+        }
+        EVIC_restore_interrupts(status);
+    }
+}
+
+static void DEBOUNCE_tick(uint32_t channel, uintptr_t context)
+{
+    (void)context;
+
+    for(int i = 0; i < DEBOUNCE_MAX_PINS; i++){
+        DEBOUNCE_Object *obj = &debounceObjects[i];
+        if(obj->pin == DEBOUNCE_PIN_UNUSED || obj->counter == 0)
+            continue;
+
+        bool sample = GPIO_pin_read(obj->pin);
+        if(sample != obj->sample){
+            /*Still bouncing, restart the window*/
+            obj->sample = sample;
+            obj->counter = obj->ticks;
+            continue;
+        }
+        if(--obj->counter != 0)
+            continue;
+
+        if(sample != obj->state){
+            obj->state = sample;
+            if(obj->callback != NULL)
+                obj->callback(obj->pin, sample, obj->context);
+        }
+        GPIO_pin_interrupt_set(obj->pin, true);
+
+        uint32_t status = EVIC_disable_interrupts();
+        if(--activePins == 0){
+            TMR_interrupt_set(channel, false);
+            TMR_stop(channel);
+        }
+        EVIC_restore_interrupts(status);
+    }
+}
+
+static DEBOUNCE_Object* DEBOUNCE_object_get(GPIO_PinMap pin)
+{
+    for(int i = 0; i < DEBOUNCE_MAX_PINS; i++){
+        if(debounceObjects[i].pin == pin)
+            return &debounceObjects[i];
+    }
+    return NULL;
+}
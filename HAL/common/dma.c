@@ -6,17 +6,16 @@
 **********************************************************************/
 #include "dma.h"
 #include "evic.h"
-#include "pic32mz_registers.h"
+#include "system.h"
+#include "hal_family.h"
 #include <xc.h>
 #include <sys/kmem.h>
 /**********************************************************************
 * Module Preprocessor Constants
 **********************************************************************/
-#define DMA_NUMBER_OF_CHANNELS                  8
 /*********************************************************************
 * Module Preprocessor Macros
 **********************************************************************/
-#define DMA_DESCRIPTOR(channel)                 ((DMA_Descriptor)(((uint8_t*)(&DCH0CON)) + 0xC0*(channel)))
 #define DMA_EVIC_CHANNEL(channel)               (EVIC_CHANNEL_DMA0 + channel)
 /**********************************************************************
 * Module Typedefs
@@ -29,6 +28,7 @@ typedef struct{
 * Module Variable Definitions
 **********************************************************************/
 static DMA_Object dmaObjs[DMA_NUMBER_OF_CHANNELS];
+static bool dmaPowered;
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
@@ -38,9 +38,21 @@ static DMA_Object dmaObjs[DMA_NUMBER_OF_CHANNELS];
 **********************************************************************/
 int DMA_init()
 {
+    if(!dmaPowered){
+        SYS_pmd_acquire(SYS_PMD_DMA);
+        dmaPowered = true;
+    }
     DMACONSET = _DMACON_ON_MASK;
     return 0;
 }
+void DMA_deinit()
+{
+    DMACONCLR = _DMACON_ON_MASK;
+    if(dmaPowered){
+        dmaPowered = false;
+        SYS_pmd_release(SYS_PMD_DMA);
+    }
+}
 int DMA_channel_init(DMA_Channel channel, int configFlags)
 {
     DMA_DESCRIPTOR(channel)->dchcon.reg = 0x03 & configFlags;
@@ -55,7 +67,7 @@ int DMA_channel_init(DMA_Channel channel, int configFlags)
         DMA_DESCRIPTOR(channel)->dchint.set = _DCH0INT_CHBCIE_MASK;
     }
     if((configFlags & DMA_CHANNEL_CHAINED) == DMA_CHANNEL_CHAINED){
-        DMA_DESCRIPTOR(channel)->dchcon.set = _DCH1CON_CHCHNS_MASK;
+        DMA_DESCRIPTOR(channel)->dchcon.set = _DCH1CON_CHCHN_MASK;
     }
     if((configFlags & DMA_CHANNEL_CHAIN_LOWER) == DMA_CHANNEL_CHAIN_LOWER){
         DMA_DESCRIPTOR(channel)->dchcon.set = _DCH1CON_CHCHNS_MASK;
@@ -64,6 +76,12 @@ int DMA_channel_init(DMA_Channel channel, int configFlags)
         DMA_DESCRIPTOR(channel)->dchcon.clr = _DCH1CON_CHCHNS_MASK;
     }
     DMA_DESCRIPTOR(channel)->dchint.set = _DCH0INT_CHERIE_MASK;
+    if((configFlags & DMA_CHANNEL_AUTO_ENABLE) == DMA_CHANNEL_AUTO_ENABLE){
+        DMA_DESCRIPTOR(channel)->dchcon.set = _DCH0CON_CHAEN_MASK;
+    }
+    if((configFlags & DMA_CHANNEL_SOURCE_HALF_IRQ) == DMA_CHANNEL_SOURCE_HALF_IRQ){
+        DMA_DESCRIPTOR(channel)->dchint.set = _DCH0INT_CHSHIE_MASK;
+    }
     dmaObjs[channel].callback = NULL;
     return 0;
 }
@@ -74,6 +92,7 @@ int DMA_channel_config(DMA_Channel channel, DMA_CHANNEL_Config *config)
     DMA_DESCRIPTOR(channel)->dchssiz.reg = config->srcSize;
     DMA_DESCRIPTOR(channel)->dchdsiz.reg = config->dstSize;
     DMA_DESCRIPTOR(channel)->dchcsiz.reg = config->cellSize;
+    DMA_DESCRIPTOR(channel)->dchecon.clr = _DCH0ECON_CHSIRQ_MASK | _DCH0ECON_CHAIRQ_MASK;
     DMA_DESCRIPTOR(channel)->dchecon.set = config->startIrq << _DCH0ECON_CHSIRQ_POSITION;
     DMA_DESCRIPTOR(channel)->dchecon.set = config->abortIrq << _DCH0ECON_CHAIRQ_POSITION;
     DMA_DESCRIPTOR(channel)->dchint.clr = 0x000000ff;
@@ -90,6 +109,39 @@ int DMA_channel_transfer(DMA_Channel channel)
     return 0;
 }
 
+int DMA_channel_enable(DMA_Channel channel)
+{
+    DMA_DESCRIPTOR(channel)->dchcon.set = _DCH0CON_CHEN_MASK;
+    return 0;
+}
+
+int DMA_channel_abort(DMA_Channel channel)
+{
+    DMA_DESCRIPTOR(channel)->dchecon.set = _DCH0ECON_CABORT_MASK;
+    while(DMA_DESCRIPTOR(channel)->dchecon.reg & _DCH0ECON_CABORT_MASK);
+    DMA_DESCRIPTOR(channel)->dchcon.clr = _DCH0CON_CHEN_MASK;
+    return 0;
+}
+
+bool DMA_channel_is_busy(DMA_Channel channel)
+{
+    return (DMA_DESCRIPTOR(channel)->dchcon.reg & _DCH0CON_CHEN_MASK) == _DCH0CON_CHEN_MASK;
+}
+
+bool DMA_is_active(void)
+{
+    for(DMA_Channel channel = 0; channel < DMA_NUMBER_OF_CHANNELS; channel++){
+        if(DMA_channel_is_busy(channel))
+            return true;
+    }
+    return false;
+}
+
+uint32_t DMA_channel_destination_pointer_get(DMA_Channel channel)
+{
+    return DMA_DESCRIPTOR(channel)->dchdptr.reg;
+}
+
 void DMA_callback_register(DMA_Channel channel, DMA_Callback callback, uintptr_t context)
 {
     dmaObjs[channel].callback = callback;
@@ -98,7 +150,11 @@ void DMA_callback_register(DMA_Channel channel, DMA_Callback callback, uintptr_t
 
 void DMA_interrupt_handler(DMA_Channel channel){
     DMA_IRQ_CAUSE cause = 0;
-    if((DMA_DESCRIPTOR(channel)->dchint.reg & _DCH0INT_CHBCIF_MASK) == _DCH0INT_CHBCIF_MASK){
+    if((DMA_DESCRIPTOR(channel)->dchint.reg & _DCH0INT_CHSHIF_MASK) == _DCH0INT_CHSHIF_MASK){
+        cause = DMA_IRQ_CAUSE_SOURCE_HALF_EMPTY;
+        DMA_DESCRIPTOR(channel)->dchint.clr = _DCH0INT_CHSHIF_MASK;
+    }
+    else if((DMA_DESCRIPTOR(channel)->dchint.reg & _DCH0INT_CHBCIF_MASK) == _DCH0INT_CHBCIF_MASK){
         cause = DMA_IRQ_CAUSE_TRANSFER_COMPLETE;
         DMA_DESCRIPTOR(channel)->dchint.clr = _DCH0INT_CHBCIF_MASK;
     }
@@ -0,0 +1,94 @@
+//
+// Created by bruno on 28/01/23.
+//
+
+#include <xc.h>
+#include "hal_delay.h"
+#include "hal_time.h"
+#include "evic.h"
+#include "system.h"
+
+static uint32_t uSeconds = (HAL_SYSTEM_CLOCK / MICRO_SECONDS) >> 1;
+static uint32_t mSeconds = (HAL_SYSTEM_CLOCK / MILLI_SECONDS) >> 1;
+
+void HAL_delay_ms(uint32_t ms)
+{
+    uint32_t t_wait = mSeconds * ms;
+    uint32_t t_start = _CP0_GET_COUNT();
+    t_start=_CP0_GET_COUNT();
+    while((_CP0_GET_COUNT()-t_start)<t_wait);
+}
+void HAL_delay_us(uint32_t us)
+{
+    uint32_t t_wait = uSeconds * us;
+    uint32_t t_start = _CP0_GET_COUNT();
+    t_start=_CP0_GET_COUNT();
+    while((_CP0_GET_COUNT()-t_start)<t_wait);
+}
+void HAL_delay_cy(uint32_t cy)
+{
+    uint32_t tStart;
+    tStart=_CP0_GET_COUNT();
+    while((_CP0_GET_COUNT()-tStart)<cy);
+}
+void HAL_delay_clock_update(uint32_t systemClock)
+{
+    uSeconds = (systemClock / MICRO_SECONDS) >> 1;
+    mSeconds = (systemClock / MILLI_SECONDS) >> 1;
+}
+
+void HAL_delay_start(HAL_Delay *delay, uint32_t us)
+{
+    delay->deadline = HAL_time_now() + HAL_time_us_to_ticks(us);
+}
+void HAL_delay_start_ms(HAL_Delay *delay, uint32_t ms)
+{
+    delay->deadline = HAL_time_now() + HAL_time_us_to_ticks((uint64_t)ms * MILLI_SECONDS);
+}
+bool HAL_delay_elapsed(const HAL_Delay *delay)
+{
+    return HAL_time_now() >= delay->deadline;
+}
+uint32_t HAL_delay_remaining_us(const HAL_Delay *delay)
+{
+    uint64_t now = HAL_time_now();
+    if(now >= delay->deadline)
+        return 0;
+    return (delay->deadline - now) / (HAL_time_frequency_get() / MICRO_SECONDS);
+}
+
+void HAL_delay_idle_until(const HAL_Delay *delay)
+{
+    HAL_TIME_Event wake;
+
+    /*The event only has to wake the core, the deadline is checked here*/
+    HAL_time_event_init(&wake, NULL, 0);
+    HAL_time_event_start_at(&wake, delay->deadline);
+    for(;;){
+        uint32_t status = EVIC_disable_interrupts();
+        if(HAL_time_now() >= delay->deadline){
+            EVIC_restore_interrupts(status);
+            break;
+        }
+        /*A pending interrupt releases wait even with interrupts disabled, it is serviced on restore*/
+        SYS_idle();
+        EVIC_restore_interrupts(status);
+    }
+    HAL_time_event_stop(&wake);
+}
+void HAL_delay_idle_ms(uint32_t ms)
+{
+    HAL_Delay delay;
+    HAL_delay_start_ms(&delay, ms);
+    HAL_delay_idle_until(&delay);
+}
+void HAL_delay_idle_us(uint32_t us)
+{
+    HAL_Delay delay;
+    if(us < HAL_DELAY_IDLE_MIN_US){
+        HAL_delay_us(us);
+        return;
+    }
+    HAL_delay_start(&delay, us);
+    HAL_delay_idle_until(&delay);
+}
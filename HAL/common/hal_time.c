@@ -0,0 +1,238 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include <xc.h>
+#include "hal_time.h"
+#include "evic.h"
+#include "hal_delay.h"
+#include "system.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+/*Compare is never programmed further than half the Count range so the 64 bit extension never misses a wrap*/
+#define HAL_TIME_MAX_INTERVAL               (0x80000000UL)
+/*Deadlines closer than this are programmed at this distance so the interrupt is never lost*/
+#define HAL_TIME_MIN_INTERVAL               (64)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static HAL_TIME_Event *timeEvents;
+static uint32_t timeHigh;
+static uint32_t timeLast;
+static uint32_t timeFrequency = HAL_SYSTEM_CLOCK >> 1;
+/*Time in ns at epochTicks, moved forward on every clock change*/
+static uint64_t epochTicks;
+static uint64_t epochNs;
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static uint64_t HAL_time_extend(uint32_t count);
+static void HAL_time_compare_update(void);
+static void HAL_time_unlink(HAL_TIME_Event *event);
+static uint64_t HAL_time_scale(uint64_t value, uint32_t mul, uint32_t div);
+static void HAL_time_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+void        HAL_time_initialize         (void)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    timeEvents = NULL;
+    timeHigh = 0;
+    timeLast = _CP0_GET_COUNT();
+    timeFrequency = SYS_clock_frequency_get() >> 1;
+    epochTicks = epochNs = 0;
+    HAL_time_compare_update();
+    EVIC_channel_pending_clear(EVIC_CHANNEL_CORE_TIMER);
+    EVIC_channel_set(EVIC_CHANNEL_CORE_TIMER);
+    EVIC_restore_interrupts(status);
+
+    SYS_clock_notifier_unregister(HAL_time_clock_changed, 0);
+    SYS_clock_notifier_register(HAL_time_clock_changed, 0);
+}
+
+uint32_t    HAL_time_frequency_get      (void)
+{
+    return timeFrequency;
+}
+
+uint64_t    HAL_time_now                (void)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    uint64_t now = HAL_time_extend(_CP0_GET_COUNT());
+    EVIC_restore_interrupts(status);
+    return now;
+}
+
+uint64_t    HAL_time_now_us             (void)
+{
+    return HAL_time_now_ns() / 1000;
+}
+
+uint64_t    HAL_time_now_ns             (void)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    uint64_t ticks = HAL_time_extend(_CP0_GET_COUNT());
+    uint64_t ns = epochNs + HAL_time_scale(ticks - epochTicks, 1000000000UL, timeFrequency);
+    EVIC_restore_interrupts(status);
+    return ns;
+}
+
+uint64_t    HAL_time_us_to_ticks        (uint64_t us)
+{
+    return us * (timeFrequency / MICRO_SECONDS);
+}
+
+uint64_t    HAL_time_ns_to_ticks        (uint64_t ns)
+{
+    uint64_t seconds = ns / 1000000000ULL;
+    return seconds * timeFrequency + ((ns % 1000000000ULL) * timeFrequency + 999999999ULL) / 1000000000ULL;
+}
+
+uint64_t    HAL_time_next_deadline      (void)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    uint64_t deadline = timeEvents != NULL ? timeEvents->deadline : HAL_TIME_NEVER;
+    EVIC_restore_interrupts(status);
+    return deadline;
+}
+
+void        HAL_time_event_init         (HAL_TIME_Event *event, HAL_TIME_Callback callback, uintptr_t context)
+{
+    event->next = NULL;
+    event->deadline = HAL_TIME_NEVER;
+    event->active = false;
+    event->callback = callback;
+    event->context = context;
+}
+
+void        HAL_time_event_start_at     (HAL_TIME_Event *event, uint64_t deadline)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    if(event->active)
+        HAL_time_unlink(event);
+
+    /*Events are kept sorted by deadline, the head is the one Compare is programmed for*/
+    HAL_TIME_Event **link = &timeEvents;
+    while(*link != NULL && (*link)->deadline <= deadline)
+        link = &(*link)->next;
+    event->deadline = deadline;
+    event->next = *link;
+    event->active = true;
+    *link = event;
+
+    if(timeEvents == event)
+        HAL_time_compare_update();
+    EVIC_restore_interrupts(status);
+}
+
+void        HAL_time_event_start        (HAL_TIME_Event *event, uint64_t delayNs)
+{
+    HAL_time_event_start_at(event, HAL_time_now() + HAL_time_ns_to_ticks(delayNs));
+}
+
+void        HAL_time_event_stop         (HAL_TIME_Event *event)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    if(event->active){
+        bool head = timeEvents == event;
+        HAL_time_unlink(event);
+        if(head)
+            HAL_time_compare_update();
+    }
+    EVIC_restore_interrupts(status);
+}
+
+bool        HAL_time_event_is_active    (HAL_TIME_Event *event)
+{
+    return event->active;
+}
+
+void        HAL_time_interrupt_handler  (void)
+{
+    for(;;){
+        uint32_t status = EVIC_disable_interrupts();
+        HAL_TIME_Event *event = timeEvents;
+        if(event == NULL || event->deadline > HAL_time_extend(_CP0_GET_COUNT())){
+            HAL_time_compare_update();
+            EVIC_channel_pending_clear(EVIC_CHANNEL_CORE_TIMER);
+            EVIC_restore_interrupts(status);
+            return;
+        }
+        HAL_time_unlink(event);
+        EVIC_restore_interrupts(status);
+
+        /*The callback may restart the event or start others*/
+        if(event->callback != NULL)
+            event->callback(event, event->context);
+    }
+}
+
+static uint64_t HAL_time_extend(uint32_t count)
+{
+    if(count < timeLast)
+        timeHigh++;
+    timeLast = count;
+    return ((uint64_t)timeHigh << 32) | count;
+}
+
+static void HAL_time_compare_update(void)
+{
+    uint64_t now = HAL_time_extend(_CP0_GET_COUNT());
+    uint64_t interval = HAL_TIME_MAX_INTERVAL;
+
+    if(timeEvents != NULL && timeEvents->deadline < now + HAL_TIME_MAX_INTERVAL)
+        interval = timeEvents->deadline > now ? timeEvents->deadline - now : 0;
+    if(interval < HAL_TIME_MIN_INTERVAL)
+        interval = HAL_TIME_MIN_INTERVAL;
+
+    /*Writing Compare also acknowledges the core timer interrupt*/
+    _CP0_SET_COMPARE((uint32_t)(now + interval));
+}
+
+static void HAL_time_unlink(HAL_TIME_Event *event)
+{
+    HAL_TIME_Event **link = &timeEvents;
+    while(*link != NULL && *link != event)
+        link = &(*link)->next;
+    if(*link != NULL)
+        *link = event->next;
+    event->next = NULL;
+    event->active = false;
+}
+
+/*value * mul / div without overflowing the intermediate product*/
+static uint64_t HAL_time_scale(uint64_t value, uint32_t mul, uint32_t div)
+{
+    return (value / div) * mul + ((value % div) * mul) / div;
+}
+
+static void HAL_time_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context)
+{
+    (void)oldFrequency;
+    (void)context;
+    uint32_t status = EVIC_disable_interrupts();
+    uint64_t now = HAL_time_extend(_CP0_GET_COUNT());
+    uint32_t old = timeFrequency;
+
+    epochNs += HAL_time_scale(now - epochTicks, 1000000000UL, old);
+    epochTicks = now;
+    timeFrequency = newFrequency >> 1;
+
+    /*Remaining time is kept, scaling is monotonic so the list stays sorted*/
+    for(HAL_TIME_Event *event = timeEvents; event != NULL; event = event->next){
+        if(event->deadline > now && event->deadline != HAL_TIME_NEVER)
+            event->deadline = now + HAL_time_scale(event->deadline - now, timeFrequency, old);
+    }
+    HAL_time_compare_update();
+    EVIC_restore_interrupts(status);
+}
@@ -0,0 +1,501 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "i2c.h"
+#include "hal_family.h"
+#include "evic.h"
+#include "system.h"
+#include "hal_time.h"
+#include "hal_delay.h"
+#include <xc.h>
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+/*Pulse gobbler delay of the SDA/SCL inputs*/
+#define I2C_TPGD_NS                         (104)
+#define I2C_BRG_MIN                         (2)
+#define I2C_RECOVERY_CLOCKS                 (9)
+#define I2C_RECOVERY_HALF_PERIOD_US         (5)
+
+#define I2C_STATE_IDLE                      (0)
+#define I2C_STATE_START                     (1)
+#define I2C_STATE_WRITE                     (2)
+#define I2C_STATE_RESTART                   (3)
+#define I2C_STATE_ADDRESS_READ              (4)
+#define I2C_STATE_READ                      (5)
+#define I2C_STATE_ACK                       (6)
+#define I2C_STATE_STOP                      (7)
+#define I2C_STATE_RECOVER                   (8)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+#define I2C_BUS_INTERRUPT_CHANNEL(channel)      (halI2cIrqBase[channel])
+#define I2C_MASTER_INTERRUPT_CHANNEL(channel)   (halI2cIrqBase[channel] + 2)
+#define I2C_PIN_IS_SET(pin)                     (((pin) & GPIO_PIN_MASK) != 0)
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    I2C_Transaction *head;
+    I2C_Transaction *tail;
+    uint32_t        state;
+    size_t          count;
+    int             result;
+    uint32_t        frequency;
+    uint32_t        timeoutUs;
+    GPIO_PinMap     sclPin;
+    GPIO_PinMap     sdaPin;
+    HAL_TIME_Event  watchdog;
+    uint32_t        recoveryStep;
+    bool            busy;
+    bool            powered;
+}I2C_Object;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static I2C_Object i2cObjects[I2C_NUMBER_OF_CHANNELS];
+static bool i2cClockNotifier;
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static uint32_t I2C_brg_get(uint32_t frequency);
+static void I2C_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context);
+static void I2C_busy_set(I2C_Object *i2cObj, bool busy);
+static void I2C_start(uint32_t i2cChannel);
+static void I2C_stop(uint32_t i2cChannel, int result);
+static void I2C_complete(uint32_t i2cChannel);
+static void I2C_finish(uint32_t i2cChannel);
+static void I2C_next(uint32_t i2cChannel);
+static void I2C_recover_step(uint32_t i2cChannel);
+static void I2C_master_service(uint32_t i2cChannel);
+static void I2C_bus_service(uint32_t i2cChannel);
+static void I2C_watchdog(HAL_TIME_Event *event, uintptr_t context);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         I2C_initialize              (uint32_t i2cChannel, uint32_t configFlags, uint32_t frequency)
+{
+    if(!I2C_CHANNEL_PRESENT(i2cChannel) || frequency == 0)
+        return -1;
+
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+    if(!i2cObj->powered){
+        SYS_pmd_acquire(SYS_PMD_I2C(i2cChannel));
+        i2cObj->powered = true;
+        i2cObj->timeoutUs = I2C_DEFAULT_TIMEOUT_US;
+    }
+    EVIC_channel_clr(I2C_MASTER_INTERRUPT_CHANNEL(i2cChannel));
+    EVIC_channel_clr(I2C_BUS_INTERRUPT_CHANNEL(i2cChannel));
+    I2C_DESCRIPTOR(i2cChannel)->i2ccon.reg = 0;
+    I2C_DESCRIPTOR(i2cChannel)->i2cstat.reg = 0;
+
+    i2cObj->head = i2cObj->tail = NULL;
+    i2cObj->state = I2C_STATE_IDLE;
+    i2cObj->frequency = frequency;
+    HAL_time_event_init(&i2cObj->watchdog, I2C_watchdog, i2cChannel);
+    I2C_DESCRIPTOR(i2cChannel)->i2cbrg.reg = I2C_brg_get(frequency);
+    if(!i2cClockNotifier)
+        i2cClockNotifier = SYS_clock_notifier_register(I2C_clock_changed, 0);
+
+    /*Slew rate control is meant for 400 kHz only*/
+    if(frequency <= I2C_SPEED_STANDARD || frequency > I2C_SPEED_FAST)
+        I2C_DESCRIPTOR(i2cChannel)->i2ccon.set = _I2C1CON_DISSLW_MASK;
+    if(configFlags & I2C_SMBUS_LEVELS)
+        I2C_DESCRIPTOR(i2cChannel)->i2ccon.set = _I2C1CON_SMEN_MASK;
+
+    EVIC_channel_pending_clear(I2C_MASTER_INTERRUPT_CHANNEL(i2cChannel));
+    EVIC_channel_pending_clear(I2C_BUS_INTERRUPT_CHANNEL(i2cChannel));
+    EVIC_channel_set(I2C_MASTER_INTERRUPT_CHANNEL(i2cChannel));
+    EVIC_channel_set(I2C_BUS_INTERRUPT_CHANNEL(i2cChannel));
+    I2C_DESCRIPTOR(i2cChannel)->i2ccon.set = _I2C1CON_ON_MASK;
+    return 0;
+}
+
+/*Queued transactions fail with I2C_ERROR_ABORTED, without callbacks*/
+void        I2C_deinitialize            (uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+
+    EVIC_channel_clr(I2C_MASTER_INTERRUPT_CHANNEL(i2cChannel));
+    EVIC_channel_clr(I2C_BUS_INTERRUPT_CHANNEL(i2cChannel));
+    I2C_DESCRIPTOR(i2cChannel)->i2ccon.reg = 0;
+    HAL_time_event_stop(&i2cObj->watchdog);
+
+    uint32_t status = EVIC_disable_interrupts();
+    for(I2C_Transaction *t = i2cObj->head; t != NULL; t = t->next)
+        t->status = I2C_ERROR_ABORTED;
+    i2cObj->head = i2cObj->tail = NULL;
+    i2cObj->state = I2C_STATE_IDLE;
+    EVIC_restore_interrupts(status);
+
+    I2C_busy_set(i2cObj, false);
+    i2cObj->frequency = 0;
+    if(i2cObj->powered){
+        i2cObj->powered = false;
+        SYS_pmd_release(SYS_PMD_I2C(i2cChannel));
+    }
+}
+
+/*0 disables the timeout, it applies from the next transaction on*/
+void        I2C_timeout_set             (uint32_t i2cChannel, uint32_t us)
+{
+    i2cObjects[i2cChannel].timeoutUs = us;
+}
+
+void        I2C_recovery_pins_set       (uint32_t i2cChannel, GPIO_PinMap sclPin, GPIO_PinMap sdaPin)
+{
+    i2cObjects[i2cChannel].sclPin = sclPin;
+    i2cObjects[i2cChannel].sdaPin = sdaPin;
+}
+
+/*Clocks SCL until a slave stuck in the middle of a byte releases SDA, then leaves the bus with a STOP*/
+bool        I2C_bus_recover             (uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+    GPIO_PinMap scl = i2cObj->sclPin;
+    GPIO_PinMap sda = i2cObj->sdaPin;
+
+    if(!I2C_PIN_IS_SET(scl) || !I2C_PIN_IS_SET(sda))
+        return false;
+
+    bool on = (I2C_DESCRIPTOR(i2cChannel)->i2ccon.reg & _I2C1CON_ON_MASK) != 0;
+    I2C_DESCRIPTOR(i2cChannel)->i2ccon.clr = _I2C1CON_ON_MASK;
+
+    GPIO_pin_initialize(scl, GPIO_OUTPUT_OD | GPIO_INIT_HIGH);
+    GPIO_pin_initialize(sda, GPIO_OUTPUT_OD | GPIO_INIT_HIGH);
+    HAL_delay_us(I2C_RECOVERY_HALF_PERIOD_US);
+    for(uint32_t i = 0; i < I2C_RECOVERY_CLOCKS && !GPIO_pin_read(sda); i++){
+        GPIO_pin_write(scl, GPIO_LOW);
+        HAL_delay_us(I2C_RECOVERY_HALF_PERIOD_US);
+        GPIO_pin_write(scl, GPIO_HIGH);
+        HAL_delay_us(I2C_RECOVERY_HALF_PERIOD_US);
+    }
+    GPIO_pin_write(scl, GPIO_LOW);
+    GPIO_pin_write(sda, GPIO_LOW);
+    HAL_delay_us(I2C_RECOVERY_HALF_PERIOD_US);
+    GPIO_pin_write(scl, GPIO_HIGH);
+    HAL_delay_us(I2C_RECOVERY_HALF_PERIOD_US);
+    GPIO_pin_write(sda, GPIO_HIGH);
+    HAL_delay_us(I2C_RECOVERY_HALF_PERIOD_US);
+
+    bool released = GPIO_pin_read(scl) && GPIO_pin_read(sda);
+    if(on)
+        I2C_DESCRIPTOR(i2cChannel)->i2ccon.set = _I2C1CON_ON_MASK;
+    return released;
+}
+
+bool        I2C_submit                  (uint32_t i2cChannel, I2C_Transaction *transaction)
+{
+    if(!I2C_CHANNEL_PRESENT(i2cChannel) || transaction == NULL || i2cObjects[i2cChannel].frequency == 0)
+        return false;
+
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+    if((transaction->writeSize != 0 && transaction->writeBuffer == NULL) ||
+       (transaction->readSize != 0 && transaction->readBuffer == NULL))
+        return false;
+
+    uint32_t status = EVIC_disable_interrupts();
+    if(transaction->status > 0){
+        EVIC_restore_interrupts(status);
+        return false;
+    }
+    transaction->status = I2C_STATUS_QUEUED;
+    transaction->next = NULL;
+    if(i2cObj->tail != NULL)
+        i2cObj->tail->next = transaction;
+    else
+        i2cObj->head = transaction;
+    i2cObj->tail = transaction;
+    if(i2cObj->state == I2C_STATE_IDLE)
+        I2C_start(i2cChannel);
+    EVIC_restore_interrupts(status);
+    return true;
+}
+
+int         I2C_wait                    (I2C_Transaction *transaction)
+{
+    for(;;){
+        uint32_t status = EVIC_disable_interrupts();
+        if(transaction->status <= 0){
+            EVIC_restore_interrupts(status);
+            break;
+        }
+        /*A pending interrupt releases wait even with interrupts disabled, it is serviced on restore*/
+        SYS_idle();
+        EVIC_restore_interrupts(status);
+    }
+    return transaction->status;
+}
+
+int         I2C_write_read              (uint32_t i2cChannel, uint8_t address, const void *txBuffer, size_t txSize,
+                                         void *rxBuffer, size_t rxSize)
+{
+    I2C_Transaction transaction = I2C_TRANSACTION(address, txBuffer, txSize, rxBuffer, rxSize);
+
+    if(!I2C_submit(i2cChannel, &transaction))
+        return I2C_ERROR_ABORTED;
+    return I2C_wait(&transaction);
+}
+
+bool        I2C_is_busy                 (uint32_t i2cChannel)
+{
+    return i2cObjects[i2cChannel].head != NULL || i2cObjects[i2cChannel].state == I2C_STATE_RECOVER;
+}
+
+/*Where the sources share a vector both are serviced from here*/
+void        I2C_interrupt_handler       (uint32_t i2cChannel)
+{
+    if(EVIC_channel_pending_get(I2C_BUS_INTERRUPT_CHANNEL(i2cChannel)))
+        I2C_bus_service(i2cChannel);
+    if(EVIC_channel_pending_get(I2C_MASTER_INTERRUPT_CHANNEL(i2cChannel)))
+        I2C_master_service(i2cChannel);
+}
+
+/*Runs with interrupts disabled or from the master interrupt*/
+static void I2C_start(uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+
+    I2C_busy_set(i2cObj, true);
+    i2cObj->head->status = I2C_STATUS_ACTIVE;
+    i2cObj->state = I2C_STATE_START;
+    i2cObj->result = I2C_STATUS_DONE;
+    if(i2cObj->timeoutUs != 0)
+        HAL_time_event_start(&i2cObj->watchdog, (uint64_t)i2cObj->timeoutUs * 1000);
+    I2C_DESCRIPTOR(i2cChannel)->i2ccon.set = _I2C1CON_SEN_MASK;
+}
+
+static void I2C_stop(uint32_t i2cChannel, int result)
+{
+    i2cObjects[i2cChannel].result = result;
+    i2cObjects[i2cChannel].state = I2C_STATE_STOP;
+    I2C_DESCRIPTOR(i2cChannel)->i2ccon.set = _I2C1CON_PEN_MASK;
+}
+
+static void I2C_complete(uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+
+    HAL_time_event_stop(&i2cObj->watchdog);
+    i2cObj->state = I2C_STATE_IDLE;
+    I2C_finish(i2cChannel);
+    I2C_next(i2cChannel);
+}
+
+/*The transaction leaves the queue before its callback, which may submit it again*/
+static void I2C_finish(uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+    I2C_Transaction *t = i2cObj->head;
+
+    i2cObj->head = t->next;
+    if(i2cObj->head == NULL)
+        i2cObj->tail = NULL;
+    t->next = NULL;
+    t->status = i2cObj->result;
+    if(t->callback != NULL)
+        t->callback(t, t->context);
+}
+
+/*Unless a callback already started one, the next queued transaction goes out*/
+static void I2C_next(uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+
+    if(i2cObj->state != I2C_STATE_IDLE)
+        return;
+    if(i2cObj->head != NULL)
+        I2C_start(i2cChannel);
+    else
+        I2C_busy_set(i2cObj, false);
+}
+
+/*One step per master event: start, repeated start, stop, byte sent and acknowledged, byte received, ACK sent*/
+static void I2C_master_service(uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+    I2C_Descriptor i2c = I2C_DESCRIPTOR(i2cChannel);
+    I2C_Transaction *t = i2cObj->head;
+
+    EVIC_channel_pending_clear(I2C_MASTER_INTERRUPT_CHANNEL(i2cChannel));
+    if(t == NULL || i2cObj->state == I2C_STATE_IDLE || i2cObj->state == I2C_STATE_RECOVER)
+        return;
+
+    switch(i2cObj->state){
+        case I2C_STATE_START:
+            i2cObj->count = 0;
+            /*An empty transaction only addresses the slave, a write with nothing to send probes it*/
+            if(t->writeSize != 0 || t->readSize == 0){
+                i2c->i2ctrn.reg = t->address << 1;
+                i2cObj->state = I2C_STATE_WRITE;
+            }
+            else{
+                i2c->i2ctrn.reg = (t->address << 1) | 1;
+                i2cObj->state = I2C_STATE_ADDRESS_READ;
+            }
+            break;
+        case I2C_STATE_WRITE:
+            if(i2c->i2cstat.reg & _I2C1STAT_ACKSTAT_MASK)
+                I2C_stop(i2cChannel, I2C_ERROR_NACK);
+            else if(i2cObj->count < t->writeSize)
+                i2c->i2ctrn.reg = t->writeBuffer[i2cObj->count++];
+            else if(t->readSize != 0){
+                i2cObj->state = I2C_STATE_RESTART;
+                i2c->i2ccon.set = _I2C1CON_RSEN_MASK;
+            }
+            else
+                I2C_stop(i2cChannel, I2C_STATUS_DONE);
+            break;
+        case I2C_STATE_RESTART:
+            i2cObj->count = 0;
+            i2c->i2ctrn.reg = (t->address << 1) | 1;
+            i2cObj->state = I2C_STATE_ADDRESS_READ;
+            break;
+        case I2C_STATE_ADDRESS_READ:
+            if(i2c->i2cstat.reg & _I2C1STAT_ACKSTAT_MASK)
+                I2C_stop(i2cChannel, I2C_ERROR_NACK);
+            else{
+                i2cObj->state = I2C_STATE_READ;
+                i2c->i2ccon.set = _I2C1CON_RCEN_MASK;
+            }
+            break;
+        case I2C_STATE_READ:
+            t->readBuffer[i2cObj->count++] = i2c->i2crcv.reg;
+            /*The last byte is not acknowledged so the slave lets go of SDA*/
+            if(i2cObj->count < t->readSize)
+                i2c->i2ccon.clr = _I2C1CON_ACKDT_MASK;
+            else
+                i2c->i2ccon.set = _I2C1CON_ACKDT_MASK;
+            i2cObj->state = I2C_STATE_ACK;
+            i2c->i2ccon.set = _I2C1CON_ACKEN_MASK;
+            break;
+        case I2C_STATE_ACK:
+            if(i2cObj->count < t->readSize){
+                i2cObj->state = I2C_STATE_READ;
+                i2c->i2ccon.set = _I2C1CON_RCEN_MASK;
+            }
+            else
+                I2C_stop(i2cChannel, I2C_STATUS_DONE);
+            break;
+        case I2C_STATE_STOP:
+            I2C_complete(i2cChannel);
+            break;
+        default:
+            break;
+    }
+}
+
+/*Arbitration was lost, the module is back to idle without a STOP of its own*/
+static void I2C_bus_service(uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+
+    I2C_DESCRIPTOR(i2cChannel)->i2cstat.clr = _I2C1STAT_BCL_MASK | _I2C1STAT_IWCOL_MASK;
+    EVIC_channel_pending_clear(I2C_BUS_INTERRUPT_CHANNEL(i2cChannel));
+    EVIC_channel_pending_clear(I2C_MASTER_INTERRUPT_CHANNEL(i2cChannel));
+    if(i2cObj->head == NULL || i2cObj->state == I2C_STATE_IDLE || i2cObj->state == I2C_STATE_RECOVER)
+        return;
+    i2cObj->result = I2C_ERROR_BUS_COLLISION;
+    I2C_complete(i2cChannel);
+}
+
+/*A slave stretching the clock or holding SDA stalls the master for good, the module is reset and the bus recovered.
+ Recovery runs one SCL edge per watchdog event, queued transactions wait for it to finish*/
+static void I2C_watchdog(HAL_TIME_Event *event, uintptr_t context)
+{
+    uint32_t i2cChannel = (uint32_t)context;
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+
+    uint32_t status = EVIC_disable_interrupts();
+    if(i2cObj->state == I2C_STATE_RECOVER)
+        I2C_recover_step(i2cChannel);
+    else if(i2cObj->head != NULL && i2cObj->state != I2C_STATE_IDLE){
+        I2C_DESCRIPTOR(i2cChannel)->i2ccon.clr = _I2C1CON_ON_MASK | _I2C1CON_SEN_MASK | _I2C1CON_RSEN_MASK |
+                                                 _I2C1CON_PEN_MASK | _I2C1CON_RCEN_MASK | _I2C1CON_ACKEN_MASK;
+        I2C_DESCRIPTOR(i2cChannel)->i2cstat.clr = _I2C1STAT_BCL_MASK | _I2C1STAT_IWCOL_MASK | _I2C1STAT_I2COV_MASK;
+        EVIC_channel_pending_clear(I2C_MASTER_INTERRUPT_CHANNEL(i2cChannel));
+        EVIC_channel_pending_clear(I2C_BUS_INTERRUPT_CHANNEL(i2cChannel));
+        i2cObj->result = I2C_ERROR_TIMEOUT;
+        if(I2C_PIN_IS_SET(i2cObj->sclPin) && I2C_PIN_IS_SET(i2cObj->sdaPin)){
+            i2cObj->state = I2C_STATE_RECOVER;
+            i2cObj->recoveryStep = 0;
+            GPIO_pin_initialize(i2cObj->sclPin, GPIO_OUTPUT_OD | GPIO_INIT_HIGH);
+            GPIO_pin_initialize(i2cObj->sdaPin, GPIO_OUTPUT_OD | GPIO_INIT_HIGH);
+            HAL_time_event_start(&i2cObj->watchdog, I2C_RECOVERY_HALF_PERIOD_US * 1000);
+            I2C_finish(i2cChannel);
+        }
+        else{
+            I2C_DESCRIPTOR(i2cChannel)->i2ccon.set = _I2C1CON_ON_MASK;
+            I2C_complete(i2cChannel);
+        }
+    }
+    EVIC_restore_interrupts(status);
+}
+
+/*Same sequence as I2C_bus_recover: SCL low on even steps and high on odd ones until SDA is released, then a STOP*/
+static void I2C_recover_step(uint32_t i2cChannel)
+{
+    I2C_Object *i2cObj = &i2cObjects[i2cChannel];
+    GPIO_PinMap scl = i2cObj->sclPin;
+    GPIO_PinMap sda = i2cObj->sdaPin;
+    uint32_t step = i2cObj->recoveryStep++;
+
+    /*SCL has been high for half a period on even steps*/
+    if(step < 2 * I2C_RECOVERY_CLOCKS && (step & 1) == 0 && GPIO_pin_read(sda)){
+        step = 2 * I2C_RECOVERY_CLOCKS;
+        i2cObj->recoveryStep = step + 1;
+    }
+    if(step < 2 * I2C_RECOVERY_CLOCKS)
+        GPIO_pin_write(scl, step & 1);
+    else if(step == 2 * I2C_RECOVERY_CLOCKS){
+        GPIO_pin_write(scl, GPIO_LOW);
+        GPIO_pin_write(sda, GPIO_LOW);
+    }
+    else if(step == 2 * I2C_RECOVERY_CLOCKS + 1)
+        GPIO_pin_write(scl, GPIO_HIGH);
+    else if(step == 2 * I2C_RECOVERY_CLOCKS + 2)
+        GPIO_pin_write(sda, GPIO_HIGH);
+    else{
+        I2C_DESCRIPTOR(i2cChannel)->i2ccon.set = _I2C1CON_ON_MASK;
+        i2cObj->state = I2C_STATE_IDLE;
+        I2C_next(i2cChannel);
+        return;
+    }
+    HAL_time_event_start(&i2cObj->watchdog, I2C_RECOVERY_HALF_PERIOD_US * 1000);
+}
+
+static uint32_t I2C_brg_get(uint32_t frequency)
+{
+    uint32_t clock = SYS_peripheral_clock_frequency_get(SYS_PERIPHERAL_CLOCK_2);
+    /*BRG = (1/(2*Fsck) - Tpgd) * PBCLK - 2*/
+    int32_t brg = (int32_t)(clock / (2 * frequency)) - (int32_t)(((uint64_t)clock * I2C_TPGD_NS) / 1000000000) - 2;
+
+    return brg < I2C_BRG_MIN ? I2C_BRG_MIN : (uint32_t)brg;
+}
+
+/*The BRG divides PBCLK2, the module is switched off while the divider changes*/
+static void I2C_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context)
+{
+    for(uint32_t channel = 0; channel < I2C_NUMBER_OF_CHANNELS; channel++){
+        if(i2cObjects[channel].frequency == 0)
+            continue;
+        bool on = (I2C_DESCRIPTOR(channel)->i2ccon.reg & _I2C1CON_ON_MASK) != 0;
+        I2C_DESCRIPTOR(channel)->i2ccon.clr = _I2C1CON_ON_MASK;
+        I2C_DESCRIPTOR(channel)->i2cbrg.reg = I2C_brg_get(i2cObjects[channel].frequency);
+        if(on)
+            I2C_DESCRIPTOR(channel)->i2ccon.set = _I2C1CON_ON_MASK;
+    }
+}
+
+/*A master transfer cannot survive Sleep, a non empty queue keeps the core out of it*/
+static void I2C_busy_set(I2C_Object *i2cObj, bool busy)
+{
+    if(i2cObj->busy == busy)
+        return;
+    i2cObj->busy = busy;
+    if(busy)
+        SYS_power_inhibit(SYS_POWER_SLEEP);
+    else
+        SYS_power_allow(SYS_POWER_SLEEP);
+}
@@ -0,0 +1,244 @@
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "ic.h"
+#include "hal_family.h"
+#include "evic.h"
+#include "timer.h"
+#include "system.h"
+#include <xc.h>
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+#define IC_MODE_MASK                        (7)
+#define IC_INTERRUPT_MASK                   (0x0300)
+#define IC_INTERRUPT_SHIFT                  (8)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+#define IC_CELL_SIZE(channel)               ((icObjects[channel].flags & IC_MODE_32) ? sizeof(uint32_t) : sizeof(uint16_t))
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    uint32_t        flags;
+    uint32_t        *buffer;
+    size_t          size;
+    volatile size_t head;
+    volatile size_t tail;
+    volatile size_t count;
+    IC_Callback     callback;
+    uintptr_t       context;
+    bool            powered;
+}IC_Object;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static IC_Object icObjects[IC_NUMBER_OF_CHANNELS];
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+void        IC_initialize               (uint32_t icChannel, uint32_t flags)
+{
+    if(!icObjects[icChannel].powered){
+        SYS_pmd_acquire(SYS_PMD_IC(icChannel));
+        icObjects[icChannel].powered = true;
+    }
+    icObjects[icChannel].flags = flags;
+    icObjects[icChannel].head = icObjects[icChannel].tail = icObjects[icChannel].count = 0;
+
+    IC_DESCRIPTOR(icChannel)->icxcon.reg = 0;
+    IC_DESCRIPTOR(icChannel)->icxcon.set = (flags & IC_MODE_MASK) << _IC1CON_ICM0_POSITION;
+    IC_DESCRIPTOR(icChannel)->icxcon.set = ((flags & IC_INTERRUPT_MASK) >> IC_INTERRUPT_SHIFT) << _IC1CON_ICI0_POSITION;
+    /*The 32 bit capture uses the TMR2/TMR3 pair*/
+    if(flags & (IC_MODE_USE_TMR2 | IC_MODE_32))
+        IC_DESCRIPTOR(icChannel)->icxcon.set = _IC1CON_ICTMR_MASK;
+    if(flags & IC_MODE_32)
+        IC_DESCRIPTOR(icChannel)->icxcon.set = _IC1CON_C32_MASK;
+    if(flags & IC_FIRST_EDGE_RISING)
+        IC_DESCRIPTOR(icChannel)->icxcon.set = _IC1CON_FEDGE_MASK;
+}
+void        IC_deinitialize             (uint32_t icChannel)
+{
+    IC_interrupt_set(icChannel, false);
+    IC_DESCRIPTOR(icChannel)->icxcon.reg = 0;
+    if(icObjects[icChannel].powered){
+        icObjects[icChannel].powered = false;
+        SYS_pmd_release(SYS_PMD_IC(icChannel));
+    }
+}
+void        IC_enable                   (uint32_t icChannel)
+{
+    IC_DESCRIPTOR(icChannel)->icxcon.set = _IC1CON_ON_MASK;
+}
+void        IC_disable                  (uint32_t icChannel)
+{
+    IC_DESCRIPTOR(icChannel)->icxcon.clr = _IC1CON_ON_MASK;
+}
+uint32_t    IC_timer_get                (uint32_t icChannel)
+{
+    if(icObjects[icChannel].flags & IC_MODE_32)
+        return TMR_CHANNEL_23;
+    return (icObjects[icChannel].flags & IC_MODE_USE_TMR2) ? TMR_CHANNEL_2 : TMR_CHANNEL_3;
+}
+bool        IC_data_available           (uint32_t icChannel)
+{
+    return (IC_DESCRIPTOR(icChannel)->icxcon.reg & _IC1CON_ICBNE_MASK) != 0;
+}
+bool        IC_overflow_get             (uint32_t icChannel)
+{
+    return (IC_DESCRIPTOR(icChannel)->icxcon.reg & _IC1CON_ICOV_MASK) != 0;
+}
+uint32_t    IC_read                     (uint32_t icChannel)
+{
+    return IC_DESCRIPTOR(icChannel)->icxbuf.reg;
+}
+size_t      IC_fifo_read                (uint32_t icChannel, uint32_t *buffer, size_t size)
+{
+    size_t count = 0;
+    while(count < size && (IC_DESCRIPTOR(icChannel)->icxcon.reg & _IC1CON_ICBNE_MASK))
+        buffer[count++] = IC_DESCRIPTOR(icChannel)->icxbuf.reg;
+    return count;
+}
+
+void        IC_buffer_set               (uint32_t icChannel, uint32_t *buffer, size_t size)
+{
+    IC_Object *obj = &icObjects[icChannel];
+    uint32_t status = EVIC_disable_interrupts();
+    obj->buffer = buffer;
+    obj->size = size;
+    obj->head = obj->tail = obj->count = 0;
+    EVIC_restore_interrupts(status);
+}
+size_t      IC_buffer_count             (uint32_t icChannel)
+{
+    return icObjects[icChannel].count;
+}
+size_t      IC_buffer_read              (uint32_t icChannel, uint32_t *buffer, size_t size)
+{
+    IC_Object *obj = &icObjects[icChannel];
+    size_t count = 0;
+
+    uint32_t status = EVIC_disable_interrupts();
+    while(count < size && obj->count != 0){
+        buffer[count++] = obj->buffer[obj->tail];
+        if(++obj->tail == obj->size)
+            obj->tail = 0;
+        obj->count--;
+    }
+    EVIC_restore_interrupts(status);
+    return count;
+}
+void        IC_callback_register        (uint32_t icChannel, IC_Callback callback, uintptr_t context)
+{
+    icObjects[icChannel].callback = callback;
+    icObjects[icChannel].context = context;
+}
+void        IC_interrupt_set            (uint32_t icChannel, bool state)
+{
+    EVIC_channel_pending_clear(halIcIrqChannels[icChannel]);
+    if(state)
+        EVIC_channel_set(halIcIrqChannels[icChannel]);
+    else
+        EVIC_channel_clr(halIcIrqChannels[icChannel]);
+}
+void        IC_interrupt_handler        (uint32_t icChannel)
+{
+    IC_Object *obj = &icObjects[icChannel];
+
+    /*Drain the whole FIFO, the interrupt is only raised every ICI captures*/
+    while(IC_DESCRIPTOR(icChannel)->icxcon.reg & _IC1CON_ICBNE_MASK){
+        uint32_t value = IC_DESCRIPTOR(icChannel)->icxbuf.reg;
+        if(obj->buffer == NULL || obj->count == obj->size)
+            continue;
+        obj->buffer[obj->head] = value;
+        if(++obj->head == obj->size)
+            obj->head = 0;
+        obj->count++;
+    }
+    EVIC_channel_pending_clear(halIcIrqChannels[icChannel]);
+    if(obj->callback != NULL)
+        obj->callback(icChannel, obj->context);
+}
+
+bool        IC_dma_start                (uint32_t icChannel, DMA_Channel dmaChannel, void *buffer, size_t count, bool circular)
+{
+    size_t cellSize = IC_CELL_SIZE(icChannel);
+
+    if(buffer == NULL || count == 0 || count * cellSize > DMA_MAX_TRANSFER_SIZE)
+        return false;
+
+    /*The capture event flag triggers the transfer, the CPU interrupt stays disabled.
+     One transfer moves one capture, so the flag has to be raised on every capture or the FIFO overruns*/
+    IC_interrupt_set(icChannel, false);
+    IC_DESCRIPTOR(icChannel)->icxcon.clr = (IC_INTERRUPT_MASK >> IC_INTERRUPT_SHIFT) << _IC1CON_ICI0_POSITION;
+    icObjects[icChannel].flags &= ~IC_INTERRUPT_MASK;
+    DMA_channel_init(dmaChannel, DMA_CHANNEL_PRIORITY_3 | DMA_CHANNEL_START_IRQ | (circular ? DMA_CHANNEL_AUTO_ENABLE : 0));
+    DMA_CHANNEL_Config dmaConfig = {
+            .startIrq = halIcIrqChannels[icChannel],
+            .cellSize = cellSize,
+            .srcSize = cellSize,
+            .srcAddress = (uint32_t)&IC_DESCRIPTOR(icChannel)->icxbuf.reg,
+            .dstSize = count * cellSize,
+            .dstAddress = (uint32_t)buffer,
+    };
+    DMA_channel_config(dmaChannel, &dmaConfig);
+    DMA_channel_enable(dmaChannel);
+    return true;
+}
+void        IC_dma_stop                 (uint32_t icChannel, DMA_Channel dmaChannel)
+{
+    (void)icChannel;
+    DMA_channel_abort(dmaChannel);
+}
+size_t      IC_dma_index_get            (uint32_t icChannel, DMA_Channel dmaChannel)
+{
+    return DMA_channel_destination_pointer_get(dmaChannel) / IC_CELL_SIZE(icChannel);
+}
+
+uint32_t    IC_ticks_elapsed            (uint32_t icChannel, uint32_t start, uint32_t end)
+{
+    /*The timer counts from 0 to PR and then resets*/
+    uint32_t period = TMR_period_get(IC_timer_get(icChannel));
+    if(end >= start)
+        return end - start;
+    return (period - start) + end + 1;
+}
+uint32_t    IC_frequency_measure        (uint32_t icChannel, const uint32_t *timestamps, size_t count)
+{
+    uint64_t total = 0;
+
+    if(count < 2)
+        return 0;
+    for(size_t i = 1; i < count; i++)
+        total += IC_ticks_elapsed(icChannel, timestamps[i - 1], timestamps[i]);
+    if(total == 0)
+        return 0;
+    return ((uint64_t)TMR_tick_frequency_get(IC_timer_get(icChannel)) * (count - 1) + total / 2) / total;
+}
+bool        IC_pulse_measure            (uint32_t icChannel, const uint32_t *timestamps, size_t count, bool firstRising,
+                                         IC_Measurement *measurement)
+{
+    uint64_t period = 0;
+    uint64_t high = 0;
+    uint32_t cycles = 0;
+
+    /*Timestamps alternate between rising and falling edges, as captured by IC_MODE_EVERY_EDGE*/
+    for(size_t i = firstRising ? 0 : 1; i + 2 < count; i += 2){
+        high += IC_ticks_elapsed(icChannel, timestamps[i], timestamps[i + 1]);
+        period += IC_ticks_elapsed(icChannel, timestamps[i], timestamps[i + 2]);
+        cycles++;
+    }
+    if(cycles == 0 || period == 0)
+        return false;
+
+    measurement->period = period / cycles;
+    measurement->highTime = high / cycles;
+    measurement->frequency = ((uint64_t)TMR_tick_frequency_get(IC_timer_get(icChannel)) * cycles + period / 2) / period;
+    measurement->duty = (high * 10000) / period;
+    return true;
+}
@@ -0,0 +1,273 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "keypad.h"
+#include "timer.h"
+#include "evic.h"
+#include "hal_ring_buffer.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+#define KEYPAD_TIMER_NONE                   (0xFFFFFFFF)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    GPIO_Port       port;
+    uint32_t        maskA;
+    uint32_t        maskB;
+    uint8_t         state;
+    int32_t         accumulator;
+    uint32_t        steps;
+    int32_t         position;
+}KEYPAD_Encoder;
+
+typedef struct{
+    GPIO_Port       rowPort;
+    uint32_t        rowMask;
+    GPIO_Port       colPort;
+    uint32_t        colMask;
+    uint32_t        rowBits[KEYPAD_MAX_ROWS];
+    uint32_t        rowCount;
+    uint32_t        colCount;
+    uint32_t        row;
+    uint32_t        samples[KEYPAD_MAX_ROWS];
+    uint32_t        states[KEYPAD_MAX_ROWS];
+}KEYPAD_Matrix;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+/*Quadrature transitions indexed by (previous << 2) | current, current being (A << 1) | B*/
+static const int8_t keypadQuadratureTable[16] = {
+        0, -1,  1,  0,
+        1,  0,  0, -1,
+       -1,  0,  0,  1,
+        0,  1, -1,  0,
+};
+static KEYPAD_Matrix keypadMatrix;
+static KEYPAD_Encoder keypadEncoders[KEYPAD_MAX_ENCODERS];
+static uint32_t keypadEncoderCount;
+static uint32_t keypadTimer = KEYPAD_TIMER_NONE;
+static uint8_t keypadEventBuffer[KEYPAD_EVENT_QUEUE_SIZE];
+static RingBuffer keypadEvents;
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static void KEYPAD_tick(uint32_t channel, uintptr_t context);
+static void KEYPAD_change_notice(GPIO_PinMap pins, uintptr_t context);
+static void KEYPAD_event_push(uint8_t event);
+static void KEYPAD_pins_initialize(GPIO_Port port, uint32_t mask, int flags);
+static uint8_t KEYPAD_encoder_read(KEYPAD_Encoder *encoder);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         KEYPAD_initialize           (uint32_t tmrChannel, uint32_t scanFrequency)
+{
+    if(scanFrequency == 0)
+        return -1;
+
+    ring_buffer_initialize(&keypadEvents, KEYPAD_EVENT_QUEUE_SIZE, keypadEventBuffer);
+    keypadMatrix.rowCount = 0;
+    keypadEncoderCount = 0;
+    keypadTimer = tmrChannel;
+
+    TMR_initialize(tmrChannel, TMR_PRESCALER_256, 0);
+    TMR_frequency_set(tmrChannel, scanFrequency);
+    TMR_callback_register(tmrChannel, KEYPAD_tick, 0);
+    return 0;
+}
+
+int         KEYPAD_matrix_set           (GPIO_Port rowPort, uint32_t rowMask, GPIO_Port colPort, uint32_t colMask)
+{
+    KEYPAD_Matrix *m = &keypadMatrix;
+    uint32_t rowCount = 0;
+    uint32_t colCount = 0;
+
+    rowMask &= GPIO_PIN_MASK;
+    colMask &= GPIO_PIN_MASK;
+    for(uint32_t bit = GPIO_PIN_0; bit & GPIO_PIN_MASK; bit <<= 1){
+        if(colMask & bit)
+            colCount++;
+        if((rowMask & bit) == 0)
+            continue;
+        if(rowCount == KEYPAD_MAX_ROWS)
+            return -1;
+        m->rowBits[rowCount++] = bit;
+    }
+    if(rowCount == 0 || colCount == 0 || rowCount * colCount > KEYPAD_MAX_KEYS)
+        return -1;
+
+    m->rowPort = rowPort;
+    m->rowMask = rowMask;
+    m->colPort = colPort;
+    m->colMask = colMask;
+    m->colCount = colCount;
+    m->row = 0;
+    for(uint32_t i = 0; i < rowCount; i++)
+        m->samples[i] = m->states[i] = 0;
+
+    /*Rows are open drain and active low, so two pressed keys can never short two driven rows*/
+    KEYPAD_pins_initialize(colPort, colMask, GPIO_INPUT_PULLUP);
+    KEYPAD_pins_initialize(rowPort, rowMask, GPIO_OUTPUT_OD);
+    GPIO_port_modify(rowPort, rowMask & ~m->rowBits[0], m->rowBits[0]);
+    m->rowCount = rowCount;
+    return 0;
+}
+
+int         KEYPAD_encoder_register     (GPIO_PinMap pinA, GPIO_PinMap pinB, uint32_t stepsPerDetent)
+{
+    if(keypadEncoderCount == KEYPAD_MAX_ENCODERS || (pinA & GPIO_PORT_MASK) != (pinB & GPIO_PORT_MASK) ||
+            GPIO_callback_register(pinA >> GPIO_PORT_SHIFT, KEYPAD_change_notice, 0) < 0)
+        return -1;
+
+    KEYPAD_Encoder *encoder = &keypadEncoders[keypadEncoderCount];
+    encoder->port = pinA >> GPIO_PORT_SHIFT;
+    encoder->maskA = pinA & GPIO_PIN_MASK;
+    encoder->maskB = pinB & GPIO_PIN_MASK;
+    encoder->steps = stepsPerDetent == 0 ? 1 : stepsPerDetent;
+    encoder->accumulator = 0;
+    encoder->position = 0;
+
+    KEYPAD_pins_initialize(encoder->port, encoder->maskA | encoder->maskB, GPIO_INPUT_PULLUP);
+    encoder->state = KEYPAD_encoder_read(encoder);
+
+    uint32_t status = EVIC_disable_interrupts();
+    keypadEncoderCount++;
+    EVIC_restore_interrupts(status);
+
+    GPIO_pin_interrupt_set(pinA, true);
+    GPIO_pin_interrupt_set(pinB, true);
+    return keypadEncoderCount - 1;
+}
+
+void        KEYPAD_start                (void)
+{
+    if(keypadTimer == KEYPAD_TIMER_NONE)
+        return;
+    TMR_start(keypadTimer);
+    TMR_interrupt_set(keypadTimer, true);
+}
+
+void        KEYPAD_stop                 (void)
+{
+    if(keypadTimer == KEYPAD_TIMER_NONE)
+        return;
+    TMR_interrupt_set(keypadTimer, false);
+    TMR_stop(keypadTimer);
+}
+
+bool        KEYPAD_event_get            (uint8_t *event)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    bool result = ring_buffer_pull(&keypadEvents, event);
+    EVIC_restore_interrupts(status);
+    return result;
+}
+
+bool        KEYPAD_key_state_get        (uint32_t key)
+{
+    KEYPAD_Matrix *m = &keypadMatrix;
+    if(m->rowCount == 0 || key >= m->rowCount * m->colCount)
+        return false;
+
+    uint32_t col = key % m->colCount;
+    for(uint32_t bit = GPIO_PIN_0; bit & GPIO_PIN_MASK; bit <<= 1){
+        if((m->colMask & bit) && col-- == 0)
+            return (m->states[key / m->colCount] & bit) != 0;
+    }
+    return false;
+}
+
+int32_t     KEYPAD_encoder_position_get (uint32_t encoder)
+{
+    if(encoder >= keypadEncoderCount)
+        return 0;
+    return keypadEncoders[encoder].position;
+}
+
+static void KEYPAD_tick(uint32_t channel, uintptr_t context)
+{
+    (void)channel;
+    (void)context;
+    KEYPAD_Matrix *m = &keypadMatrix;
+
+    if(m->rowCount == 0)
+        return;
+
+    /*The row selected on the previous tick has settled for a whole period, columns read low when pressed*/
+    uint32_t row = m->row;
+    uint32_t pressed = ~GPIO_port_read(m->colPort, m->colMask) & m->colMask;
+
+    /*A key changes state only after two consecutive scans agree*/
+    if(pressed == m->samples[row] && pressed != m->states[row]){
+        uint32_t changed = pressed ^ m->states[row];
+        uint32_t key = row * m->colCount;
+        for(uint32_t bit = GPIO_PIN_0; bit & GPIO_PIN_MASK; bit <<= 1){
+            if((m->colMask & bit) == 0)
+                continue;
+            if(changed & bit)
+                KEYPAD_event_push(((pressed & bit) ? KEYPAD_EVENT_KEY_PRESS : KEYPAD_EVENT_KEY_RELEASE) | key);
+            key++;
+        }
+        m->states[row] = pressed;
+    }
+    m->samples[row] = pressed;
+
+    if(++row == m->rowCount)
+        row = 0;
+    m->row = row;
+    GPIO_port_modify(m->rowPort, m->rowMask & ~m->rowBits[row], m->rowBits[row]);
+}
+
+static void KEYPAD_change_notice(GPIO_PinMap pins, uintptr_t context)
+{
+    (void)context;
+    GPIO_Port port = pins >> GPIO_PORT_SHIFT;
+
+    for(uint32_t i = 0; i < keypadEncoderCount; i++){
+        KEYPAD_Encoder *encoder = &keypadEncoders[i];
+        if(encoder->port != port)
+            continue;
+
+        uint8_t state = KEYPAD_encoder_read(encoder);
+        encoder->accumulator += keypadQuadratureTable[(encoder->state << 2) | state];
+        encoder->state = state;
+
+        if(encoder->accumulator >= (int32_t)encoder->steps){
+            encoder->accumulator = 0;
+            encoder->position++;
+            KEYPAD_event_push(KEYPAD_EVENT_ENCODER_CW | i);
+        }
+        else if(encoder->accumulator <= -(int32_t)encoder->steps){
+            encoder->accumulator = 0;
+            encoder->position--;
+            KEYPAD_event_push(KEYPAD_EVENT_ENCODER_CCW | i);
+        }
+    }
+}
+
+static void KEYPAD_event_push(uint8_t event)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    ring_buffer_push(&keypadEvents, event);
+    EVIC_restore_interrupts(status);
+}
+
+static void KEYPAD_pins_initialize(GPIO_Port port, uint32_t mask, int flags)
+{
+    for(uint32_t bit = GPIO_PIN_0; bit & GPIO_PIN_MASK; bit <<= 1){
+        if(mask & bit)
+            GPIO_pin_initialize(GPIO_PIN_MAP(port, bit), flags);
+    }
+}
+
+static uint8_t KEYPAD_encoder_read(KEYPAD_Encoder *encoder)
+{
+    uint32_t value = GPIO_port_read(encoder->port, encoder->maskA | encoder->maskB);
+    return ((value & encoder->maskA) ? 2 : 0) | ((value & encoder->maskB) ? 1 : 0);
+}
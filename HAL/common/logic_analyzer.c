@@ -0,0 +1,264 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "logic_analyzer.h"
+#include "hal_family.h"
+#include "timer.h"
+#include "dma.h"
+#include "evic.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+#define LA_RLE_RECORD_MAX_SIZE              (7)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+#define LA_PORT_ADDRESS(p)                  ((uint32_t)(&GPIO_get_descriptor(p)->port.reg))
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    LA_Config       config;
+    volatile LA_STATE state;
+    GPIO_PinMap     triggerPins;
+    bool            preWrapped;
+    size_t          preEnd;
+    LA_Callback     callback;
+    uintptr_t       context;
+}LA_Object;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static LA_Object laObject;
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static void LA_trigger_pins_set(GPIO_PinMap pins, bool state);
+static void LA_change_notice(GPIO_PinMap pins, uintptr_t context);
+static void LA_pre_dma_callback(DMA_Channel channel, DMA_IRQ_CAUSE cause, uintptr_t context);
+static void LA_post_dma_callback(DMA_Channel channel, DMA_IRQ_CAUSE cause, uintptr_t context);
+static size_t LA_rle_record(uint8_t *buffer, uint16_t value, uint32_t run);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         LA_initialize               (const LA_Config *config)
+{
+    if(config == NULL || config->preBuffer == NULL || config->postBuffer == NULL ||
+            config->preCount == 0 || config->postCount == 0 || config->frequency == 0 ||
+            config->preCount * sizeof(uint16_t) > DMA_MAX_TRANSFER_SIZE ||
+            config->postCount * sizeof(uint16_t) > DMA_MAX_TRANSFER_SIZE)
+        return -1;
+
+    laObject.config = *config;
+    laObject.state = LA_STATE_IDLE;
+
+    TMR_initialize(config->tmrChannel, TMR_PRESCALER_1, 0);
+    TMR_frequency_set(config->tmrChannel, config->frequency);
+
+    DMA_channel_init(config->preDmaChannel, DMA_CHANNEL_PRIORITY_3 | DMA_CHANNEL_START_IRQ | DMA_CHANNEL_AUTO_ENABLE);
+    DMA_channel_init(config->postDmaChannel, DMA_CHANNEL_PRIORITY_3 | DMA_CHANNEL_START_IRQ);
+    DMA_callback_register(config->preDmaChannel, LA_pre_dma_callback, 0);
+    DMA_callback_register(config->postDmaChannel, LA_post_dma_callback, 0);
+    return 0;
+}
+
+bool        LA_start                    (GPIO_PinMap triggerPins)
+{
+    LA_Config *config = &laObject.config;
+
+    if(laObject.state == LA_STATE_ARMED || laObject.state == LA_STATE_TRIGGERED)
+        return false;
+    if(triggerPins != LA_NO_TRIGGER && GPIO_callback_register(triggerPins >> GPIO_PORT_SHIFT, LA_change_notice, 0) < 0)
+        return false;
+
+    TMR_stop(config->tmrChannel);
+
+    DMA_CHANNEL_Config dmaConfig = {
+            .startIrq = TMR_irq_channel_get(config->tmrChannel),
+            .cellSize = sizeof(uint16_t),
+            .srcSize = sizeof(uint16_t),
+            .srcAddress = LA_PORT_ADDRESS(config->port),
+            .dstSize = config->preCount * sizeof(uint16_t),
+            .dstAddress = (uint32_t)config->preBuffer,
+    };
+    DMA_channel_config(config->preDmaChannel, &dmaConfig);
+    dmaConfig.dstSize = config->postCount * sizeof(uint16_t);
+    dmaConfig.dstAddress = (uint32_t)config->postBuffer;
+    DMA_channel_config(config->postDmaChannel, &dmaConfig);
+
+    laObject.preWrapped = false;
+    laObject.preEnd = 0;
+    laObject.triggerPins = triggerPins;
+    laObject.state = LA_STATE_ARMED;
+
+    if(triggerPins != LA_NO_TRIGGER)
+        LA_trigger_pins_set(triggerPins, true);
+
+    DMA_channel_enable(config->preDmaChannel);
+    TMR_start(config->tmrChannel);
+    return true;
+}
+
+void        LA_trigger                  (void)
+{
+    LA_Config *config = &laObject.config;
+
+    uint32_t status = EVIC_disable_interrupts();
+    if(laObject.state != LA_STATE_ARMED){
+        EVIC_restore_interrupts(status);
+        return;
+    }
+    /*Enable the post-trigger channel before stopping the circular one so no sample is lost,
+     the trigger point is accurate to one sample.*/
+    DMA_channel_enable(config->postDmaChannel);
+    laObject.preEnd = (DMA_channel_destination_pointer_get(config->preDmaChannel) / sizeof(uint16_t)) % config->preCount;
+    DMA_channel_abort(config->preDmaChannel);
+    laObject.state = LA_STATE_TRIGGERED;
+    EVIC_restore_interrupts(status);
+
+    if(laObject.triggerPins != LA_NO_TRIGGER)
+        LA_trigger_pins_set(laObject.triggerPins, false);
+}
+
+void        LA_stop                     (void)
+{
+    LA_Config *config = &laObject.config;
+
+    TMR_stop(config->tmrChannel);
+    DMA_channel_abort(config->preDmaChannel);
+    DMA_channel_abort(config->postDmaChannel);
+    if(laObject.triggerPins != LA_NO_TRIGGER)
+        LA_trigger_pins_set(laObject.triggerPins, false);
+    laObject.state = LA_STATE_IDLE;
+}
+
+LA_STATE    LA_state_get                (void)
+{
+    return laObject.state;
+}
+
+void        LA_callback_register        (LA_Callback callback, uintptr_t context)
+{
+    laObject.callback = callback;
+    laObject.context = context;
+}
+
+size_t      LA_sample_count             (void)
+{
+    if(laObject.state != LA_STATE_DONE)
+        return 0;
+    return LA_trigger_index_get() + laObject.config.postCount;
+}
+
+size_t      LA_trigger_index_get        (void)
+{
+    return laObject.preWrapped ? laObject.config.preCount : laObject.preEnd;
+}
+
+uint16_t    LA_sample_get               (size_t index)
+{
+    LA_Config *config = &laObject.config;
+    size_t preSamples = LA_trigger_index_get();
+
+    if(index >= preSamples)
+        return config->postBuffer[index - preSamples] & config->mask;
+
+    /*Oldest pre-trigger sample sits right after the last one written*/
+    if(laObject.preWrapped)
+        index = (laObject.preEnd + index) % config->preCount;
+    return config->preBuffer[index] & config->mask;
+}
+
+size_t      LA_rle_encode               (uint8_t *buffer, size_t size)
+{
+    uint8_t record[LA_RLE_RECORD_MAX_SIZE];
+    size_t count = LA_sample_count();
+    size_t written = 0;
+    size_t i = 0;
+
+    while(i < count){
+        uint16_t value = LA_sample_get(i);
+        uint32_t run = 1;
+        while(i + run < count && LA_sample_get(i + run) == value)
+            run++;
+
+        size_t length = LA_rle_record(record, value, run);
+        if(written + length > size)
+            break;
+        for(size_t j = 0; j < length; j++)
+            buffer[written++] = record[j];
+        i += run;
+    }
+    return written;
+}
+
+size_t      LA_export                   (UART_Channel channel)
+{
+    uint8_t record[LA_RLE_RECORD_MAX_SIZE];
+    size_t count = LA_sample_count();
+    size_t written = 0;
+    size_t i = 0;
+
+    while(i < count){
+        uint16_t value = LA_sample_get(i);
+        uint32_t run = 1;
+        while(i + run < count && LA_sample_get(i + run) == value)
+            run++;
+
+        written += UART_write(channel, record, LA_rle_record(record, value, run));
+        i += run;
+    }
+    return written;
+}
+
+/*Disabling also gives the change notice slot of the port back, LA_start registers it again*/
+static void LA_trigger_pins_set(GPIO_PinMap pins, bool state)
+{
+    GPIO_PinMap port = pins & GPIO_PORT_MASK;
+    for(uint32_t pin = GPIO_PIN_0; pin & GPIO_PIN_MASK; pin <<= 1){
+        if(pins & pin)
+            GPIO_pin_interrupt_set(port | pin, state);
+    }
+    if(!state)
+        GPIO_callback_unregister(pins >> GPIO_PORT_SHIFT, LA_change_notice, 0);
+}
+
+static void LA_change_notice(GPIO_PinMap pins, uintptr_t context)
+{
+    (void)context;
+    if(pins & laObject.triggerPins & GPIO_PIN_MASK)
+        LA_trigger();
+}
+
+static void LA_pre_dma_callback(DMA_Channel channel, DMA_IRQ_CAUSE cause, uintptr_t context)
+{
+    (void)channel;
+    (void)context;
+    if(cause == DMA_IRQ_CAUSE_TRANSFER_COMPLETE)
+        laObject.preWrapped = true;
+}
+
+static void LA_post_dma_callback(DMA_Channel channel, DMA_IRQ_CAUSE cause, uintptr_t context)
+{
+    (void)channel;
+    (void)context;
+    TMR_stop(laObject.config.tmrChannel);
+    laObject.state = (cause == DMA_IRQ_CAUSE_TRANSFER_COMPLETE) ? LA_STATE_DONE : LA_STATE_IDLE;
+    if(laObject.callback != NULL)
+        laObject.callback(laObject.context);
+}
+
+/*Record: sample value (little endian) followed by the run length as a 7-bit varint*/
+static size_t LA_rle_record(uint8_t *buffer, uint16_t value, uint32_t run)
+{
+    size_t length = 0;
+    buffer[length++] = value & 0xFF;
+    buffer[length++] = value >> 8;
+    while(run >= 0x80){
+        buffer[length++] = (run & 0x7F) | 0x80;
+        run >>= 7;
+    }
+    buffer[length++] = run;
+    return length;
+}
@@ -0,0 +1,249 @@
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "oc.h"
+#include "hal_family.h"
+#include "evic.h"
+#include "timer.h"
+#include "system.h"
+#include <xc.h>
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+#define OC_MODE_MASK                        (7)
+#define OC_DMA_NONE                         (0xFFFFFFFF)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+#define OC_CELL_SIZE(channel)               ((OC_DESCRIPTOR(channel)->ocxcon.reg & _OC1CON_OC32_MASK) ? sizeof(uint32_t) : sizeof(uint16_t))
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    DMA_Channel     rDmaChannel;
+    DMA_Channel     rsDmaChannel;
+    uint32_t        flags;
+    OC_DMA_Callback dmaCallback;
+    uintptr_t       dmaContext;
+    OC_Callback     callback;
+    uintptr_t       context;
+    bool            powered;
+}OC_Object;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static OC_Object ocObjects[OC_NUMBER_OF_CHANNELS] = {
+        [0 ... OC_NUMBER_OF_CHANNELS - 1] = { .rDmaChannel = OC_DMA_NONE, .rsDmaChannel = OC_DMA_NONE }
+};
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static bool OC_dma_channel_start(uint32_t ocChannel, DMA_Channel dmaChannel, volatile uint32_t *target,
+                                 const void *table, size_t count, uint32_t flags, bool events);
+static void OC_dma_callback(DMA_Channel channel, DMA_IRQ_CAUSE cause, uintptr_t context);
+
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+void        OC_initialize   (uint32_t ocChannel, uint32_t flags, uint32_t compareValue)
+{
+    if(!ocObjects[ocChannel].powered){
+        SYS_pmd_acquire(SYS_PMD_OC(ocChannel));
+        ocObjects[ocChannel].powered = true;
+    }
+    OC_DESCRIPTOR(ocChannel)->ocxcon.reg = 0;
+    OC_DESCRIPTOR(ocChannel)->ocxcon.set = (flags & OC_MODE_MASK) << _OC1CON_OCM0_POSITION;
+    if(flags & OC_MODE_32)
+        OC_DESCRIPTOR(ocChannel)->ocxcon.set = _OC1CON_OC32_MASK;
+    if(flags & OC_MODE_USE_TMR3)
+        OC_DESCRIPTOR(ocChannel)->ocxcon.set = _OC1CON_OCTSEL_MASK;
+
+    OC_DESCRIPTOR(ocChannel)->ocxr.reg  = compareValue;
+    OC_DESCRIPTOR(ocChannel)->ocxrs.reg = compareValue;
+}
+void        OC_deinitialize (uint32_t ocChannel)
+{
+    OC_dma_stop(ocChannel);
+    OC_interrupt_set(ocChannel, false);
+    OC_DESCRIPTOR(ocChannel)->ocxcon.reg = 0;
+    if(ocObjects[ocChannel].powered){
+        ocObjects[ocChannel].powered = false;
+        SYS_pmd_release(SYS_PMD_OC(ocChannel));
+    }
+}
+void        OC_enable       (uint32_t ocChannel)
+{
+    OC_DESCRIPTOR(ocChannel)->ocxcon.set = _OC1CON_ON_MASK;
+}
+void        OC_disable      (uint32_t ocChannel)
+{
+    OC_DESCRIPTOR(ocChannel)->ocxcon.clr = _OC1CON_ON_MASK;
+}
+void        OC_compare_set  (uint32_t ocChannel, uint32_t compareValue)
+{
+    OC_DESCRIPTOR(ocChannel)->ocxrs.reg = compareValue;
+}
+uint32_t    OC_compare_get  (uint32_t ocChannel)
+{
+    return OC_DESCRIPTOR(ocChannel)->ocxrs.reg;
+}
+uint32_t    OC_timer_get    (uint32_t ocChannel)
+{
+    if(OC_DESCRIPTOR(ocChannel)->ocxcon.reg & _OC1CON_OC32_MASK)
+        return TMR_CHANNEL_23;
+    return (OC_DESCRIPTOR(ocChannel)->ocxcon.reg & _OC1CON_OCTSEL_MASK) ? TMR_CHANNEL_3 : TMR_CHANNEL_2;
+}
+void        OC_mode_set     (uint32_t ocChannel, uint32_t mode)
+{
+    /*Going through the disabled mode resets the output and rearms the single pulse mode*/
+    OC_DESCRIPTOR(ocChannel)->ocxcon.clr = _OC1CON_OCM_MASK;
+    OC_DESCRIPTOR(ocChannel)->ocxcon.set = (mode & OC_MODE_MASK) << _OC1CON_OCM0_POSITION;
+}
+void        OC_compare_dual_set     (uint32_t ocChannel, uint32_t riseValue, uint32_t fallValue)
+{
+    OC_DESCRIPTOR(ocChannel)->ocxr.reg  = riseValue;
+    OC_DESCRIPTOR(ocChannel)->ocxrs.reg = fallValue;
+}
+bool        OC_pulse_start          (uint32_t ocChannel, uint32_t delayTicks, uint32_t widthTicks)
+{
+    uint32_t timer = OC_timer_get(ocChannel);
+    uint64_t period = (uint64_t)TMR_period_get(timer) + 1;
+
+    /*Both edges have to land within one timer period from now*/
+    if(delayTicks == 0 || widthTicks == 0 || (uint64_t)delayTicks + widthTicks >= period)
+        return false;
+
+    uint32_t status = EVIC_disable_interrupts();
+    uint64_t rise = ((uint64_t)TMR_count_get(timer) + delayTicks) % period;
+    uint64_t fall = (rise + widthTicks) % period;
+    OC_DESCRIPTOR(ocChannel)->ocxcon.clr = _OC1CON_OCM_MASK;
+    OC_compare_dual_set(ocChannel, rise, fall);
+    OC_DESCRIPTOR(ocChannel)->ocxcon.set = OC_MODE_SINGLE_PULSE << _OC1CON_OCM0_POSITION;
+    EVIC_restore_interrupts(status);
+    return true;
+}
+bool        OC_fault_get            (uint32_t ocChannel)
+{
+    return (OC_DESCRIPTOR(ocChannel)->ocxcon.reg & _OC1CON_OCFLT_MASK) != 0;
+}
+void        OC_fault_clear          (uint32_t ocChannel)
+{
+    /*The fault latch only clears by writing the mode again once OCFA is back high*/
+    uint32_t mode = (OC_DESCRIPTOR(ocChannel)->ocxcon.reg & _OC1CON_OCM_MASK) >> _OC1CON_OCM0_POSITION;
+    OC_mode_set(ocChannel, mode);
+}
+
+void        OC_callback_register    (uint32_t ocChannel, OC_Callback callback, uintptr_t context)
+{
+    ocObjects[ocChannel].callback = callback;
+    ocObjects[ocChannel].context = context;
+}
+void        OC_interrupt_set        (uint32_t ocChannel, bool state)
+{
+    EVIC_channel_pending_clear(halOcIrqChannels[ocChannel]);
+    if(state)
+        EVIC_channel_set(halOcIrqChannels[ocChannel]);
+    else
+        EVIC_channel_clr(halOcIrqChannels[ocChannel]);
+}
+void        OC_interrupt_handler    (uint32_t ocChannel)
+{
+    EVIC_channel_pending_clear(halOcIrqChannels[ocChannel]);
+    if(ocObjects[ocChannel].callback != NULL)
+        ocObjects[ocChannel].callback(ocChannel, ocObjects[ocChannel].context);
+}
+
+bool        OC_dma_start            (uint32_t ocChannel, DMA_Channel dmaChannel, const void *table, size_t count, uint32_t flags)
+{
+    OC_dma_stop(ocChannel);
+    if(!OC_dma_channel_start(ocChannel, dmaChannel, &OC_DESCRIPTOR(ocChannel)->ocxrs.reg, table, count, flags, true))
+        return false;
+    ocObjects[ocChannel].rsDmaChannel = dmaChannel;
+    ocObjects[ocChannel].flags = flags;
+    return true;
+}
+
+bool        OC_dma_dual_start       (uint32_t ocChannel, DMA_Channel rDmaChannel, DMA_Channel rsDmaChannel,
+                                     const void *rTable, const void *rsTable, size_t count, uint32_t flags)
+{
+    OC_dma_stop(ocChannel);
+    /*Both channels fire on the same period match and advance in step, only the OCxRS channel reports events*/
+    if(!OC_dma_channel_start(ocChannel, rDmaChannel, &OC_DESCRIPTOR(ocChannel)->ocxr.reg, rTable, count, flags, false))
+        return false;
+    ocObjects[ocChannel].rDmaChannel = rDmaChannel;
+    if(!OC_dma_channel_start(ocChannel, rsDmaChannel, &OC_DESCRIPTOR(ocChannel)->ocxrs.reg, rsTable, count, flags, true)){
+        OC_dma_stop(ocChannel);
+        return false;
+    }
+    ocObjects[ocChannel].rsDmaChannel = rsDmaChannel;
+    ocObjects[ocChannel].flags = flags;
+    return true;
+}
+
+void        OC_dma_stop             (uint32_t ocChannel)
+{
+    OC_Object *obj = &ocObjects[ocChannel];
+
+    if(obj->rsDmaChannel != OC_DMA_NONE)
+        DMA_channel_abort(obj->rsDmaChannel);
+    if(obj->rDmaChannel != OC_DMA_NONE)
+        DMA_channel_abort(obj->rDmaChannel);
+    obj->rsDmaChannel = obj->rDmaChannel = OC_DMA_NONE;
+}
+
+void        OC_dma_callback_register(uint32_t ocChannel, OC_DMA_Callback callback, uintptr_t context)
+{
+    ocObjects[ocChannel].dmaCallback = callback;
+    ocObjects[ocChannel].dmaContext = context;
+}
+
+static bool OC_dma_channel_start(uint32_t ocChannel, DMA_Channel dmaChannel, volatile uint32_t *target,
+                                 const void *table, size_t count, uint32_t flags, bool events)
+{
+    size_t cellSize = OC_CELL_SIZE(ocChannel);
+    int dmaFlags = DMA_CHANNEL_PRIORITY_3 | DMA_CHANNEL_START_IRQ;
+
+    if(table == NULL || count == 0 || count * cellSize > DMA_MAX_TRANSFER_SIZE)
+        return false;
+
+    /*A repeating table is consumed in two halves, the half that was just sent can be refilled while the other plays*/
+    if(flags & OC_DMA_REPEAT){
+        dmaFlags |= DMA_CHANNEL_AUTO_ENABLE;
+        if(events)
+            dmaFlags |= DMA_CHANNEL_SOURCE_HALF_IRQ;
+    }
+    DMA_channel_init(dmaChannel, dmaFlags);
+
+    DMA_CHANNEL_Config dmaConfig = {
+            .startIrq = TMR_irq_channel_get(OC_timer_get(ocChannel)),
+            .cellSize = cellSize,
+            .srcSize = count * cellSize,
+            .srcAddress = (uint32_t)table,
+            .dstSize = cellSize,
+            .dstAddress = (uint32_t)target,
+    };
+    DMA_channel_config(dmaChannel, &dmaConfig);
+    DMA_callback_register(dmaChannel, events ? OC_dma_callback : NULL, ocChannel);
+    DMA_channel_enable(dmaChannel);
+    return true;
+}
+
+static void OC_dma_callback(DMA_Channel channel, DMA_IRQ_CAUSE cause, uintptr_t context)
+{
+    (void)channel;
+    uint32_t ocChannel = context;
+    OC_Object *obj = &ocObjects[ocChannel];
+    uint32_t event;
+
+    if(cause == DMA_IRQ_CAUSE_SOURCE_HALF_EMPTY)
+        event = OC_DMA_EVENT_FIRST_HALF;
+    else if(cause == DMA_IRQ_CAUSE_TRANSFER_COMPLETE)
+        event = OC_DMA_EVENT_SECOND_HALF;
+    else
+        event = OC_DMA_EVENT_ERROR;
+
+    if(event != OC_DMA_EVENT_FIRST_HALF && (obj->flags & OC_DMA_REPEAT) == 0)
+        obj->rsDmaChannel = obj->rDmaChannel = OC_DMA_NONE;
+    if(obj->dmaCallback != NULL)
+        obj->dmaCallback(ocChannel, event, obj->dmaContext);
+}
@@ -0,0 +1,136 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "perf.h"
+#include "evic.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static SYS_Perf_Region *perfRegions;
+static SYS_Perf_Region *perfLast;
+static SYS_Perf_Sample perfOverhead;
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static uint32_t SYS_perf_subtract(uint32_t value, uint32_t overhead);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+void            SYS_perf_initialize     (void)
+{
+    SYS_Perf_Sample start;
+
+    SYS_perf_counter_set(SYS_PERF_COUNTER_0, SYS_PERF_INSTRUCTIONS);
+    SYS_perf_counter_set(SYS_PERF_COUNTER_1, SYS_PERF_C1_DCACHE_MISSES);
+
+    /*Two back to back samples, what they count is the cost of measuring and comes off every region*/
+    perfOverhead = (SYS_Perf_Sample){0};
+    SYS_perf_sample(&start);
+    SYS_perf_sample(&perfOverhead);
+    perfOverhead.cycles -= start.cycles;
+    for(uint32_t i = 0; i < SYS_PERF_COUNTERS; i++)
+        perfOverhead.events[i] -= start.events[i];
+}
+
+SYS_Perf_Sample SYS_perf_begin          (SYS_Perf_Region *region)
+{
+    SYS_Perf_Sample sample;
+
+    if(!region->linked){
+        uint32_t status = EVIC_disable_interrupts();
+        if(!region->linked){
+            region->linked = true;
+            region->next = NULL;
+            region->minCycles = UINT32_MAX;
+            if(perfLast != NULL)
+                perfLast->next = region;
+            else
+                perfRegions = region;
+            perfLast = region;
+        }
+        EVIC_restore_interrupts(status);
+    }
+    SYS_perf_sample(&sample);
+    sample.running = true;
+    return sample;
+}
+
+void            SYS_perf_end            (SYS_Perf_Region *region, SYS_Perf_Sample *sample)
+{
+    SYS_Perf_Sample end;
+
+    SYS_perf_sample(&end);
+    uint32_t cycles = SYS_perf_subtract(end.cycles - sample->cycles, perfOverhead.cycles);
+
+    uint32_t status = EVIC_disable_interrupts();
+    region->calls++;
+    region->cycles += cycles;
+    if(cycles < region->minCycles)
+        region->minCycles = cycles;
+    if(cycles > region->maxCycles)
+        region->maxCycles = cycles;
+    for(uint32_t i = 0; i < SYS_PERF_COUNTERS; i++)
+        region->events[i] += SYS_perf_subtract(end.events[i] - sample->events[i], perfOverhead.events[i]);
+    EVIC_restore_interrupts(status);
+    sample->running = false;
+}
+
+void            SYS_perf_result_get     (const SYS_Perf_Region *region, SYS_Perf_Result *result)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    SYS_Perf_Region copy = *region;
+    EVIC_restore_interrupts(status);
+
+    result->name = copy.name;
+    result->calls = copy.calls;
+    result->cycles = copy.calls ? copy.cycles / copy.calls : 0;
+    result->minCycles = copy.calls ? copy.minCycles : 0;
+    result->maxCycles = copy.maxCycles;
+    for(uint32_t i = 0; i < SYS_PERF_COUNTERS; i++)
+        result->events[i] = copy.calls ? copy.events[i] / copy.calls : 0;
+    result->ipcMilli = 0;
+    if(SYS_perf_counter_event_get(SYS_PERF_COUNTER_0) == SYS_PERF_INSTRUCTIONS && copy.cycles != 0)
+        result->ipcMilli = (copy.events[SYS_PERF_COUNTER_0] * 1000) / copy.cycles;
+}
+
+void            SYS_perf_report         (SYS_Perf_Report_Callback callback, uintptr_t context)
+{
+    SYS_Perf_Result result;
+
+    for(SYS_Perf_Region *region = perfRegions; region != NULL; region = region->next){
+        SYS_perf_result_get(region, &result);
+        callback(&result, context);
+    }
+}
+
+void            SYS_perf_reset          (void)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    for(SYS_Perf_Region *region = perfRegions; region != NULL; region = region->next){
+        region->calls = 0;
+        region->cycles = 0;
+        region->minCycles = UINT32_MAX;
+        region->maxCycles = 0;
+        for(uint32_t i = 0; i < SYS_PERF_COUNTERS; i++)
+            region->events[i] = 0;
+    }
+    EVIC_restore_interrupts(status);
+}
+
+static uint32_t SYS_perf_subtract(uint32_t value, uint32_t overhead)
+{
+    return value > overhead ? value - overhead : 0;
+}
@@ -0,0 +1,131 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "pwm.h"
+#include "oc.h"
+#include "timer.h"
+#include "evic.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+#define PWM_PERIOD_TICKS(group)             (TMR_period_get((group)->tmrChannel) + 1)
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static void PWM_period_match(uint32_t channel, uintptr_t context);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         PWM_group_initialize        (PWM_Group *group, uint32_t tmrChannel, const uint32_t *ocChannels, size_t count,
+                                         uint32_t frequency)
+{
+    /*OC channels can only be clocked from TMR2 or TMR3*/
+    if((tmrChannel != TMR_CHANNEL_2 && tmrChannel != TMR_CHANNEL_3) || count == 0 || count > PWM_GROUP_MAX_CHANNELS)
+        return -1;
+
+    group->tmrChannel = tmrChannel;
+    group->count = count;
+    group->pending = false;
+
+    TMR_initialize(tmrChannel, TMR_PRESCALER_1, 0);
+    if(TMR_frequency_set(tmrChannel, frequency) == 0)
+        return -1;
+
+    for(size_t i = 0; i < count; i++){
+        group->channels[i] = ocChannels[i];
+        group->staged[i] = group->committed[i] = 0;
+        OC_initialize(ocChannels[i], OC_MODE_PWM | (tmrChannel == TMR_CHANNEL_3 ? OC_MODE_USE_TMR3 : OC_MODE_USE_TMR2), 0);
+    }
+    TMR_callback_register(tmrChannel, PWM_period_match, (uintptr_t)group);
+    return 0;
+}
+
+void        PWM_group_start             (PWM_Group *group)
+{
+    for(uint32_t i = 0; i < group->count; i++)
+        OC_enable(group->channels[i]);
+    TMR_start(group->tmrChannel);
+}
+
+void        PWM_group_stop              (PWM_Group *group)
+{
+    TMR_interrupt_set(group->tmrChannel, false);
+    TMR_stop(group->tmrChannel);
+    for(uint32_t i = 0; i < group->count; i++)
+        OC_disable(group->channels[i]);
+    group->pending = false;
+}
+
+void        PWM_duty_ticks_set          (PWM_Group *group, uint32_t index, uint32_t ticks)
+{
+    uint32_t period = PWM_PERIOD_TICKS(group);
+    if(index >= group->count)
+        return;
+    group->staged[index] = ticks > period ? period : ticks;
+}
+
+void        PWM_duty_percent_set        (PWM_Group *group, uint32_t index, uint32_t duty)
+{
+    if(duty > PWM_DUTY_PERCENT_MAX)
+        duty = PWM_DUTY_PERCENT_MAX;
+    PWM_duty_ticks_set(group, index, ((uint64_t)PWM_PERIOD_TICKS(group) * duty + PWM_DUTY_PERCENT_MAX / 2) / PWM_DUTY_PERCENT_MAX);
+}
+
+void        PWM_duty_ns_set             (PWM_Group *group, uint32_t index, uint32_t ns)
+{
+    uint64_t ticks = ((uint64_t)TMR_tick_frequency_get(group->tmrChannel) * ns + 500000000ULL) / 1000000000ULL;
+    PWM_duty_ticks_set(group, index, ticks > UINT32_MAX ? UINT32_MAX : ticks);
+}
+
+void        PWM_group_commit            (PWM_Group *group)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    for(uint32_t i = 0; i < group->count; i++)
+        group->committed[i] = group->staged[i];
+    group->pending = true;
+    EVIC_restore_interrupts(status);
+
+    /*Enabling clears a stale period match, the update lands on the next period boundary*/
+    TMR_interrupt_set(group->tmrChannel, true);
+}
+
+bool        PWM_group_commit_pending    (PWM_Group *group)
+{
+    return group->pending;
+}
+
+uint32_t    PWM_resolution_get          (PWM_Group *group)
+{
+    return PWM_PERIOD_TICKS(group);
+}
+
+uint32_t    PWM_tick_ns_get             (PWM_Group *group)
+{
+    return 1000000000UL / TMR_tick_frequency_get(group->tmrChannel);
+}
+
+static void PWM_period_match(uint32_t channel, uintptr_t context)
+{
+    PWM_Group *group = (PWM_Group*)context;
+
+    /*OCxRS is copied to OCxR on the next period match, writing all of them early in this period keeps them in step*/
+    if(group->pending){
+        for(uint32_t i = 0; i < group->count; i++)
+            OC_compare_set(group->channels[i], group->committed[i]);
+        group->pending = false;
+    }
+    TMR_interrupt_set(channel, false);
+}
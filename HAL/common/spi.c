@@ -13,7 +13,7 @@
 * Includes
 **********************************************************************/
 #include "spi.h"
-#include "pic32mx_registers.h"
+#include "hal_family.h"
 #include "evic.h"
 #include <xc.h>
 #include "system.h"
@@ -21,16 +21,13 @@
 /**********************************************************************
 * Module Preprocessor Constants
 **********************************************************************/
-#define SPI_BASE                                _SPI2_BASE_ADDRESS
-#define SPI_NUMBER_OF_CHANNELS                  (3)
-#define SPI_PERIPHERAL_INTERVAL                 (0x200)
+
 /**********************************************************************
 * Module Preprocessor Macros
 **********************************************************************/
-#define SPI_DESCRIPTOR(channel)                 (descriptors[channel])
-#define SPI_RX_INTERRUPT_CHANNEL(channel)       (spiIRQBase[channel] + 1)
-#define SPI_TX_INTERRUPT_CHANNEL(channel)       (spiIRQBase[channel] + 2)
-#define SPI_FAULT_INTERRUPT_CHANNEL(channel)    (spiIRQBase[channel])
+#define SPI_RX_INTERRUPT_CHANNEL(channel)       (halSpiIrqBase[channel] + 1)
+#define SPI_TX_INTERRUPT_CHANNEL(channel)       (halSpiIrqBase[channel] + 2)
+#define SPI_FAULT_INTERRUPT_CHANNEL(channel)    (halSpiIrqBase[channel])
 /**********************************************************************
 * Module Typedefs
 **********************************************************************/
@@ -45,31 +42,32 @@ typedef struct{
     size_t          dummySize;
     SPI_Callback    callback;
     uintptr_t       context;
+    uint32_t        baudrate;
+    bool            powered;
 }SPI_Object;
 /*********************************************************************
 * Module Variable Definitions
 **********************************************************************/
 static SPI_Object spiObjects[SPI_NUMBER_OF_CHANNELS];
-static const EVIC_CHANNEL spiIRQBase[]={
-        [SPI_CHANNEL_2] = EVIC_CHANNEL_SPI2_ERR,
-        [SPI_CHANNEL_3] = EVIC_CHANNEL_SPI3_ERR,
-        [SPI_CHANNEL_4] = EVIC_CHANNEL_SPI4_ERR,
-};
-static const SPI_Descriptor descriptors[] = {
-    [SPI_CHANNEL_2] = (SPI_Descriptor)&SPI2CON,
-    [SPI_CHANNEL_3] = (SPI_Descriptor)&SPI3CON,
-    [SPI_CHANNEL_4] = (SPI_Descriptor)&SPI4CON,
-};
+static bool spiClockNotifier;
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
 static uint32_t SPI_Baudrate_Get_(uint32_t baudrate);
+static void SPI_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context);
+static void SPI_busy_set(SPI_Object *spiObj, bool busy);
+static void SPI_rx_service(SPI_Channel spiChannel);
+static void SPI_tx_service(SPI_Channel spiChannel);
 /**********************************************************************
 * Function Definitions
 **********************************************************************/
 
 int SPI_initialize(uint32_t spiChannel, uint32_t configFlags, uint32_t baudrate)
 {
+    if(!spiObjects[spiChannel].powered){
+        SYS_pmd_acquire(SYS_PMD_SPI(spiChannel));
+        spiObjects[spiChannel].powered = true;
+    }
     EVIC_channel_clr(SPI_RX_INTERRUPT_CHANNEL(spiChannel));
     EVIC_channel_clr(SPI_TX_INTERRUPT_CHANNEL(spiChannel));
     EVIC_channel_clr(SPI_FAULT_INTERRUPT_CHANNEL(spiChannel));
@@ -88,6 +86,8 @@ int SPI_initialize(uint32_t spiChannel, uint32_t configFlags, uint32_t baudrate)
         SPI_DESCRIPTOR(spiChannel)->spicon1.set = _SPI2CON_MSTEN_MASK;
 
     SPI_setup(spiChannel, configFlags, baudrate);
+    if(!spiClockNotifier)
+        spiClockNotifier = SYS_clock_notifier_register(SPI_clock_changed, 0);
 
     /*SPI data bits configuration*/
     if(configFlags & SPI_DATA_BITS_16)
@@ -107,12 +107,27 @@ int SPI_initialize(uint32_t spiChannel, uint32_t configFlags, uint32_t baudrate)
     return 0;
 }
 
+void SPI_deinitialize(uint32_t spiChannel)
+{
+    EVIC_channel_clr(SPI_RX_INTERRUPT_CHANNEL(spiChannel));
+    EVIC_channel_clr(SPI_TX_INTERRUPT_CHANNEL(spiChannel));
+    EVIC_channel_clr(SPI_FAULT_INTERRUPT_CHANNEL(spiChannel));
+    SPI_DESCRIPTOR(spiChannel)->spicon1.reg = 0;
+    SPI_busy_set(&spiObjects[spiChannel], false);
+    spiObjects[spiChannel].baudrate = 0;
+    if(spiObjects[spiChannel].powered){
+        spiObjects[spiChannel].powered = false;
+        SYS_pmd_release(SYS_PMD_SPI(spiChannel));
+    }
+}
+
 void SPI_setup (SPI_Channel spiChannel, uint32_t configFlags, uint32_t baudrate)
 {
     bool status = (SPI_DESCRIPTOR(spiChannel)->spicon1.reg & _SPI2CON_ON_MASK) == _SPI2CON_ON_MASK;
     SPI_DESCRIPTOR(spiChannel)->spicon1.clr = _SPI2CON_ON_MASK;
     uint32_t brg = SPI_Baudrate_Get_(baudrate);
     SPI_DESCRIPTOR(spiChannel)->spibrg.reg = brg;
+    spiObjects[spiChannel].baudrate = baudrate;
 
     if(configFlags & SPI_SAMPLE_END)
         SPI_DESCRIPTOR(spiChannel)->spicon1.set = _SPI2CON_SMP_MASK;
@@ -149,7 +164,7 @@ size_t SPI_transfer(uint32_t spiChannel, void *txBuffer, void *rxBuffer, size_t
     if(rxBuffer == NULL)
         rxSize = 0;
 
-    spiObjects[spiChannel].busy = true;
+    SPI_busy_set(&spiObjects[spiChannel], true);
     spiObjects[spiChannel].rxBuffer = rxBuffer;
     spiObjects[spiChannel].txBuffer = txBuffer;
     spiObjects[spiChannel].rxCount = 0;
@@ -171,7 +186,7 @@ size_t SPI_transfer(uint32_t spiChannel, void *txBuffer, void *rxBuffer, size_t
 
         /*Write Byte*/
         if(spiObjects[spiChannel].txCount != txSize){
-            SPI_DESCRIPTOR(
+                SPI_DESCRIPTOR(
                     spiChannel)->spibuf.reg = ((uint8_t*)spiObjects[spiChannel].txBuffer)[spiObjects[spiChannel].rxCount];
         }
         else{
@@ -187,13 +202,13 @@ size_t SPI_transfer(uint32_t spiChannel, void *txBuffer, void *rxBuffer, size_t
         /*Read RX FIFO*/
         receivedData = SPI_DESCRIPTOR(spiChannel)->spibuf.reg;
         if(rxBuffer != NULL){
-            ((uint8_t*)spiObjects[spiChannel].rxBuffer)[spiObjects[spiChannel].rxCount] = receivedData;
+                ((uint8_t*)spiObjects[spiChannel].rxBuffer)[spiObjects[spiChannel].rxCount] = receivedData;
         }
         spiObjects[spiChannel].rxCount++;
     }
     /*Wait for TX FIFO to empty*/
     while ((bool)((SPI_DESCRIPTOR(spiChannel)->spistat.reg & _SPI2STAT_SRMT_MASK) == false));
-    spiObjects[spiChannel].busy = false;
+    SPI_busy_set(&spiObjects[spiChannel], false);
     return spiObjects[spiChannel].rxCount;
 }
 
@@ -206,7 +221,6 @@ uint8_t SPI_byte_transfer(uint32_t spiChannel, uint8_t data)
     /*Empty RX FIFO*/
     while ((bool)(SPI_DESCRIPTOR(spiChannel)->spistat.reg & _SPI2STAT_SPIRBE_MASK) == false) {
         receivedData = SPI_DESCRIPTOR(spiChannel)->spibuf.reg;
-//        (void)receivedData;
     }
 #endif
 
@@ -220,8 +234,9 @@ uint8_t SPI_byte_transfer(uint32_t spiChannel, uint8_t data)
     return SPI_DESCRIPTOR(spiChannel)->spibuf.reg;
 }
 
-static void DMA_callback(DMA_Channel dma, DMA_IRQ_CAUSE cause, SPI_Channel channel){
-    spiObjects[channel].busy = false;
+static void DMA_callback(DMA_Channel dma, DMA_IRQ_CAUSE cause, uintptr_t context){
+    SPI_Channel channel = (SPI_Channel)context;
+    SPI_busy_set(&spiObjects[channel], false);
     if(spiObjects[channel].callback != NULL){
         spiObjects[channel].callback(channel, spiObjects[channel].context);
     }
@@ -231,8 +246,19 @@ bool        SPI_write_dma               (SPI_Channel spiChannel, uint32_t dmaCha
 {
     if(size == 0 || (txBuffer == NULL) || spiObjects[spiChannel].busy)
         return false;
+    uint32_t receivedData;
+    /*Overflow-bit clear*/
+    SPI_DESCRIPTOR(spiChannel)->spistat.clr = _SPI2STAT_SPIROV_MASK;
+
+    /*Empty RX FIFO*/
+    while ((bool)(SPI_DESCRIPTOR(spiChannel)->spistat.reg & _SPI2STAT_SPIRBE_MASK) == false) {
+        receivedData = SPI_DESCRIPTOR(spiChannel)->spibuf.reg;
+        (void)receivedData;
+    }
+    /*Wait for TX FIFO to empty*/
+    while((bool)(SPI_DESCRIPTOR(spiChannel)->spistat.reg & _SPI2STAT_SPITBE_MASK) == false);
 
-    spiObjects[spiChannel].busy = true;
+    SPI_busy_set(&spiObjects[spiChannel], true);
 
     DMA_CHANNEL_Config dmaConfig = {
             .startIrq = SPI_TX_INTERRUPT_CHANNEL(spiChannel),
@@ -247,12 +273,13 @@ bool        SPI_write_dma               (SPI_Channel spiChannel, uint32_t dmaCha
     DMA_channel_transfer(dmaChannel);
     return true;
 }
+
 bool        SPI_read_dma                (SPI_Channel spiChannel, uint32_t dmaChannel, void *rxBuffer, size_t size)
 {
     if(size == 0 || (rxBuffer == NULL) || spiObjects[spiChannel].busy)
         return false;
 
-    spiObjects[spiChannel].busy = true;
+    SPI_busy_set(&spiObjects[spiChannel], true);
 
     DMA_CHANNEL_Config dmaConfig = {
             .startIrq = SPI_TX_INTERRUPT_CHANNEL(spiChannel),
@@ -290,7 +317,7 @@ bool SPI_transfer_isr (uint32_t spiChannel, void* pTransmitData, void* pReceiveD
     if (pReceiveData != NULL)
         spiObj->rxSize = size;
 
-    spiObj->busy = true;
+    SPI_busy_set(spiObj, true);
 
     if (spiObj->rxSize > spiObj->txSize)
         spiObj->dummySize = spiObj->rxSize;
@@ -363,7 +390,7 @@ void SPI_callback_register (SPI_Channel spiChannel, SPI_Callback callback, uintp
     spiObjects[spiChannel].context = context;
 }
 
-static void SPI_rx_interrupt_handler_private (SPI_Channel spiChannel)
+static void SPI_rx_service (SPI_Channel spiChannel)
 {
     uint32_t receivedData = 0;
 
@@ -417,7 +444,7 @@ static void SPI_rx_interrupt_handler_private (SPI_Channel spiChannel)
                 EVIC_channel_clr(SPI_RX_INTERRUPT_CHANNEL(spiChannel));
 
                 /* Transfer complete. Give a callback */
-                spiObj->busy = false;
+                SPI_busy_set(spiObj, false);
 
                 if(spiObj->callback != NULL)
                 {
@@ -430,7 +457,7 @@ static void SPI_rx_interrupt_handler_private (SPI_Channel spiChannel)
     EVIC_channel_pending_clear(SPI_RX_INTERRUPT_CHANNEL(spiChannel));
 }
 
-static void SPI_tx_interrupt_handler_private (SPI_Channel spiChannel)
+static void SPI_tx_service (SPI_Channel spiChannel)
 {
     /* If there are more words to be transmitted, then transmit them here and keep track of the rxCount */
     if((SPI_DESCRIPTOR(spiChannel)->spistat.reg & _SPI2STAT_SPITBE_MASK) == _SPI2STAT_SPITBE_MASK)
@@ -460,7 +487,7 @@ static void SPI_tx_interrupt_handler_private (SPI_Channel spiChannel)
             EVIC_channel_clr(SPI_TX_INTERRUPT_CHANNEL(spiChannel));
 
             /* Transfer complete. Give a callback */
-            spiObj->busy = false;
+            SPI_busy_set(spiObj, false);
 
             if(spiObj->callback != NULL)
             {
@@ -472,33 +499,43 @@ static void SPI_tx_interrupt_handler_private (SPI_Channel spiChannel)
     EVIC_channel_pending_clear(SPI_TX_INTERRUPT_CHANNEL(spiChannel));
 }
 
-static void SPI_interrupt_handler(SPI_Channel spiChannel)
+void        SPI_interrupt_handler       (SPI_Channel spiChannel)
 {
     if(EVIC_channel_pending_get(SPI_RX_INTERRUPT_CHANNEL(spiChannel)) &&
-    EVIC_channel_get(SPI_RX_INTERRUPT_CHANNEL(spiChannel))){
-        SPI_rx_interrupt_handler_private(spiChannel);
+       EVIC_channel_get(SPI_RX_INTERRUPT_CHANNEL(spiChannel))){
+        SPI_rx_service(spiChannel);
     }
     if(EVIC_channel_pending_get(SPI_TX_INTERRUPT_CHANNEL(spiChannel)) &&
        EVIC_channel_get(SPI_TX_INTERRUPT_CHANNEL(spiChannel))){
-        SPI_tx_interrupt_handler_private(spiChannel);
+        SPI_tx_service(spiChannel);
     }
 }
 
+/*Where the sources share a vector either handler services all of them*/
 void        SPI_rx_interrupt_handler    (SPI_Channel spiChannel)
 {
+#if HAL_SHARED_PERIPHERAL_VECTORS
     SPI_interrupt_handler(spiChannel);
+#else
+    SPI_rx_service(spiChannel);
+#endif
 }
+
 void        SPI_tx_interrupt_handler    (SPI_Channel spiChannel)
 {
+#if HAL_SHARED_PERIPHERAL_VECTORS
     SPI_interrupt_handler(spiChannel);
+#else
+    SPI_tx_service(spiChannel);
+#endif
 }
 
 SPI_IRQ_Vector* SPI_get_irq_vector_base          (SPI_Channel spiChannel)
 {
     static SPI_IRQ_Vector v;
-    v.fault = spiIRQBase[spiChannel];
-    v.rx = spiIRQBase[spiChannel]+1;
-    v.tx = spiIRQBase[spiChannel] +2;
+    v.fault = halSpiIrqBase[spiChannel];
+    v.rx = halSpiIrqBase[spiChannel]+1;
+    v.tx = halSpiIrqBase[spiChannel] +2;
     return &v;
 }
 SPI_Descriptor SPI_get_descriptor      (SPI_Channel channel)
@@ -519,4 +556,30 @@ static uint32_t SPI_Baudrate_Get_(uint32_t baudrate){
         brg++;
 
     return brg;
-}
\ No newline at end of file
+}
+
+/*The BRG divides PBCLK2, the module is switched off while the divider changes*/
+static void SPI_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context)
+{
+    for(uint32_t channel = 0; channel < SPI_NUMBER_OF_CHANNELS; channel++){
+        if(spiObjects[channel].baudrate == 0)
+            continue;
+        bool on = (SPI_DESCRIPTOR(channel)->spicon1.reg & _SPI2CON_ON_MASK) != 0;
+        SPI_DESCRIPTOR(channel)->spicon1.clr = _SPI2CON_ON_MASK;
+        SPI_DESCRIPTOR(channel)->spibrg.reg = SPI_Baudrate_Get_(spiObjects[channel].baudrate);
+        if(on)
+            SPI_DESCRIPTOR(channel)->spicon1.set = _SPI2CON_ON_MASK;
+    }
+}
+
+/*The SPI clock stops in Sleep, an ongoing transfer keeps the core out of it*/
+static void SPI_busy_set(SPI_Object *spiObj, bool busy)
+{
+    if(spiObj->busy == busy)
+        return;
+    spiObj->busy = busy;
+    if(busy)
+        SYS_power_inhibit(SYS_POWER_SLEEP);
+    else
+        SYS_power_allow(SYS_POWER_SLEEP);
+}
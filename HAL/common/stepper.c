@@ -0,0 +1,296 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "stepper.h"
+#include "timer.h"
+#include "evic.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+/*Austin's first step factor 0.676 in Q10*/
+#define STEPPER_C0_FACTOR                   (692)
+/*The S-curve starts from this fraction of the top speed instead of standing still*/
+#define STEPPER_SCURVE_START_DIVIDER        (32)
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    uint32_t            tmrChannel;
+    GPIO_PinMap         stepPin;
+    GPIO_PinMap         dirPin;
+    const uint32_t      *ramp;
+    size_t              rampLength;
+    volatile bool       busy;
+    bool                stepHigh;
+    int32_t             direction;
+    volatile uint32_t   remaining;
+    uint32_t            speedIndex;
+    volatile int32_t    position;
+    STEPPER_Callback    callback;
+    uintptr_t           context;
+}STEPPER_Axis;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static STEPPER_Axis stepperAxes[STEPPER_MAX_AXES];
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static void STEPPER_step(uint32_t channel, uintptr_t context);
+static void STEPPER_half_period_load(STEPPER_Axis *axis);
+static uint64_t STEPPER_isqrt(uint64_t value);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         STEPPER_axis_initialize     (uint32_t axis, uint32_t tmrChannel, uint32_t tmrFlags, GPIO_PinMap stepPin,
+                                         GPIO_PinMap dirPin)
+{
+    if(axis >= STEPPER_MAX_AXES)
+        return -1;
+
+    STEPPER_Axis *obj = &stepperAxes[axis];
+    obj->tmrChannel = tmrChannel;
+    obj->stepPin = stepPin;
+    obj->dirPin = dirPin;
+    obj->ramp = NULL;
+    obj->rampLength = 0;
+    obj->busy = false;
+    obj->position = 0;
+
+    GPIO_pin_initialize(stepPin, GPIO_OUTPUT);
+    GPIO_pin_write(stepPin, false);
+    if(dirPin != GPIO_PIN_INVALID)
+        GPIO_pin_initialize(dirPin, GPIO_OUTPUT);
+
+    TMR_initialize(tmrChannel, tmrFlags & (TMR_TCKPS_MASK | TMR_MODE_32), 0);
+    TMR_callback_register(tmrChannel, STEPPER_step, axis);
+    return 0;
+}
+
+uint32_t    STEPPER_tick_frequency_get  (uint32_t axis)
+{
+    return TMR_tick_frequency_get(stepperAxes[axis].tmrChannel);
+}
+
+/*Austin's recurrence c(n) = c(n-1) - 2c(n-1)/(4n+1) with c(0) = 0.676 * F * sqrt(2/a), in Q8 ticks*/
+size_t      STEPPER_ramp_trapezoid      (uint32_t axis, uint32_t *table, size_t size, uint32_t maxSpeed,
+                                         uint32_t acceleration)
+{
+    uint64_t frequency = STEPPER_tick_frequency_get(axis);
+    size_t length = 0;
+
+    if(size == 0 || maxSpeed == 0 || acceleration == 0)
+        return 0;
+
+    uint64_t cMin = (frequency << 8) / maxSpeed;
+    uint64_t c = ((STEPPER_isqrt((2 * frequency * frequency) / acceleration) * STEPPER_C0_FACTOR) << 8) >> 10;
+    if(c < cMin)
+        c = cMin;
+
+    while(length < size){
+        table[length++] = (uint32_t)(c >> 8);
+        if(c <= cMin)
+            break;
+        c -= (2 * c) / (4 * length + 1);
+        if(c < cMin)
+            c = cMin;
+    }
+    STEPPER_ramp_set(axis, table, length);
+    return length;
+}
+
+/*Speed follows v(t) = vmax * (3x^2 - 2x^3) with x = t / T, evaluated step by step in Q16*/
+size_t      STEPPER_ramp_scurve         (uint32_t axis, uint32_t *table, size_t size, uint32_t maxSpeed, uint32_t rampMs)
+{
+    uint64_t frequency = STEPPER_tick_frequency_get(axis);
+    uint64_t rampTicks = (frequency * rampMs) / 1000;
+    uint32_t minSpeed = maxSpeed / STEPPER_SCURVE_START_DIVIDER;
+    uint64_t t = 0;
+    size_t length = 0;
+
+    if(size == 0 || maxSpeed == 0 || rampTicks == 0)
+        return 0;
+    if(minSpeed == 0)
+        minSpeed = 1;
+
+    while(length < size && t < rampTicks){
+        uint64_t x = (t << 16) / rampTicks;
+        uint64_t x2 = (x * x) >> 16;
+        uint64_t x3 = (x2 * x) >> 16;
+        uint32_t speed = (uint32_t)((maxSpeed * (3 * x2 - 2 * x3)) >> 16);
+        if(speed < minSpeed)
+            speed = minSpeed;
+
+        uint32_t period = frequency / speed;
+        table[length++] = period;
+        t += period;
+    }
+    if(length < size)
+        table[length++] = frequency / maxSpeed;
+    STEPPER_ramp_set(axis, table, length);
+    return length;
+}
+
+void        STEPPER_ramp_set            (uint32_t axis, const uint32_t *table, size_t length)
+{
+    stepperAxes[axis].ramp = table;
+    stepperAxes[axis].rampLength = length;
+}
+
+bool        STEPPER_move                (uint32_t axis, int32_t steps)
+{
+    STEPPER_Axis *obj = &stepperAxes[axis];
+
+    if(obj->busy || obj->rampLength == 0 || steps == 0)
+        return false;
+
+    obj->direction = steps > 0 ? 1 : -1;
+    obj->remaining = steps > 0 ? steps : -steps;
+    obj->speedIndex = 0;
+    obj->stepHigh = false;
+    if(obj->dirPin != GPIO_PIN_INVALID)
+        GPIO_pin_write(obj->dirPin, steps > 0);
+    return true;
+}
+
+void        STEPPER_start               (uint32_t axisMask)
+{
+    for(uint32_t i = 0; i < STEPPER_MAX_AXES; i++){
+        STEPPER_Axis *obj = &stepperAxes[i];
+        if((axisMask & STEPPER_AXIS_MASK(i)) == 0 || obj->remaining == 0)
+            continue;
+        STEPPER_half_period_load(obj);
+        TMR_interrupt_set(obj->tmrChannel, true);
+    }
+
+    /*All timers start back to back so the axes stay in step*/
+    uint32_t status = EVIC_disable_interrupts();
+    for(uint32_t i = 0; i < STEPPER_MAX_AXES; i++){
+        STEPPER_Axis *obj = &stepperAxes[i];
+        if((axisMask & STEPPER_AXIS_MASK(i)) == 0 || obj->remaining == 0)
+            continue;
+        obj->busy = true;
+        TMR_start(obj->tmrChannel);
+    }
+    EVIC_restore_interrupts(status);
+}
+
+void        STEPPER_halt                (uint32_t axisMask)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    for(uint32_t i = 0; i < STEPPER_MAX_AXES; i++){
+        STEPPER_Axis *obj = &stepperAxes[i];
+        /*Leave just enough steps to ramp down from the current speed*/
+        if((axisMask & STEPPER_AXIS_MASK(i)) && obj->busy && obj->remaining > obj->speedIndex + 1)
+            obj->remaining = obj->speedIndex + 1;
+    }
+    EVIC_restore_interrupts(status);
+}
+
+void        STEPPER_stop                (uint32_t axisMask)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    for(uint32_t i = 0; i < STEPPER_MAX_AXES; i++){
+        STEPPER_Axis *obj = &stepperAxes[i];
+        if((axisMask & STEPPER_AXIS_MASK(i)) == 0 || !obj->busy)
+            continue;
+        TMR_stop(obj->tmrChannel);
+        TMR_interrupt_set(obj->tmrChannel, false);
+        GPIO_pin_write(obj->stepPin, false);
+        obj->remaining = 0;
+        obj->busy = false;
+    }
+    EVIC_restore_interrupts(status);
+}
+
+bool        STEPPER_is_busy             (uint32_t axisMask)
+{
+    for(uint32_t i = 0; i < STEPPER_MAX_AXES; i++){
+        if((axisMask & STEPPER_AXIS_MASK(i)) && stepperAxes[i].busy)
+            return true;
+    }
+    return false;
+}
+
+int32_t     STEPPER_position_get        (uint32_t axis)
+{
+    return stepperAxes[axis].position;
+}
+
+void        STEPPER_position_set        (uint32_t axis, int32_t position)
+{
+    stepperAxes[axis].position = position;
+}
+
+void        STEPPER_callback_register   (uint32_t axis, STEPPER_Callback callback, uintptr_t context)
+{
+    stepperAxes[axis].callback = callback;
+    stepperAxes[axis].context = context;
+}
+
+static void STEPPER_step(uint32_t channel, uintptr_t context)
+{
+    STEPPER_Axis *obj = &stepperAxes[context];
+
+    /*Every interrupt is half a step period, the driver steps on the rising edge*/
+    GPIO_pin_toggle(obj->stepPin);
+    obj->stepHigh = !obj->stepHigh;
+    if(!obj->stepHigh)
+        return;
+
+    obj->position += obj->direction;
+    if(--obj->remaining == 0){
+        TMR_stop(channel);
+        TMR_interrupt_set(channel, false);
+        GPIO_pin_write(obj->stepPin, false);
+        obj->stepHigh = false;
+        obj->busy = false;
+        if(obj->callback != NULL)
+            obj->callback(context, obj->context);
+        return;
+    }
+
+    /*Decelerate once the remaining steps only cover the way down the ramp*/
+    if(obj->remaining <= obj->speedIndex)
+        obj->speedIndex--;
+    else if(obj->speedIndex + 1 < obj->rampLength)
+        obj->speedIndex++;
+    STEPPER_half_period_load(obj);
+}
+
+static void STEPPER_half_period_load(STEPPER_Axis *obj)
+{
+    uint32_t max = TMR_is_32bit(obj->tmrChannel) ? UINT32_MAX : UINT16_MAX;
+    uint32_t half = obj->ramp[obj->speedIndex] >> 1;
+
+    if(half == 0)
+        half = 1;
+    if(half - 1 > max)
+        half = max + 1;
+    /*Called from the timer callback or with the timer stopped, staging would delay the ramp by one interrupt*/
+    TMR_period_load(obj->tmrChannel, half - 1);
+}
+
+static uint64_t STEPPER_isqrt(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while(bit > value)
+        bit >>= 2;
+    while(bit != 0){
+        if(value >= result + bit){
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+            result >>= 1;
+        bit >>= 2;
+    }
+    return result;
+}
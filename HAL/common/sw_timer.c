@@ -0,0 +1,208 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "sw_timer.h"
+#include "timer.h"
+#include "evic.h"
+#include "hal_delay.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+#define SWT_WHEEL_MASK                      (SWT_WHEEL_SIZE - 1)
+
+#if (SWT_WHEEL_SIZE & SWT_WHEEL_MASK) != 0
+#error "SWT_WHEEL_SIZE must be a power of two"
+#endif
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static SWT_Timer *swtWheel[SWT_WHEEL_SIZE];
+static SWT_Timer *swtNext;
+static SWT_Timer *swtDeferredHead;
+static SWT_Timer *swtDeferredTail;
+static volatile uint32_t swtTicks;
+static uint32_t swtTickUs;
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static void SWT_tick(uint32_t channel, uintptr_t context);
+static void SWT_link(SWT_Timer *timer, uint32_t ticks);
+static void SWT_unlink(SWT_Timer *timer);
+static void SWT_expire(SWT_Timer *timer);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         SWT_initialize              (uint32_t tmrChannel, uint32_t tickUs)
+{
+    if(tickUs == 0)
+        return -1;
+
+    for(int i = 0; i < SWT_WHEEL_SIZE; i++)
+        swtWheel[i] = NULL;
+    swtNext = swtDeferredHead = swtDeferredTail = NULL;
+    swtTicks = 0;
+    swtTickUs = tickUs;
+
+    TMR_initialize(tmrChannel, TMR_PRESCALER_256, 0);
+    TMR_frequency_set(tmrChannel, MICRO_SECONDS / tickUs);
+    TMR_callback_register(tmrChannel, SWT_tick, 0);
+    TMR_start(tmrChannel);
+    TMR_interrupt_set(tmrChannel, true);
+    return 0;
+}
+
+uint32_t    SWT_ticks_get               (void)
+{
+    return swtTicks;
+}
+
+uint32_t    SWT_ms_to_ticks             (uint32_t ms)
+{
+    return (uint32_t)(((uint64_t)ms * 1000 + swtTickUs - 1) / swtTickUs);
+}
+
+void        SWT_timer_init              (SWT_Timer *timer, SWT_Callback callback, uintptr_t context, uint32_t flags)
+{
+    timer->next = timer->prev = timer->deferredNext = NULL;
+    timer->slot = 0;
+    timer->rounds = 0;
+    timer->period = 0;
+    timer->flags = flags;
+    timer->active = timer->pending = timer->queued = false;
+    timer->callback = callback;
+    timer->context = context;
+}
+
+void        SWT_timer_start             (SWT_Timer *timer, uint32_t ticks)
+{
+    if(ticks == 0)
+        ticks = 1;
+
+    uint32_t status = EVIC_disable_interrupts();
+    if(timer->active)
+        SWT_unlink(timer);
+    timer->period = ticks;
+    timer->active = true;
+    SWT_link(timer, ticks);
+    EVIC_restore_interrupts(status);
+}
+
+void        SWT_timer_stop              (SWT_Timer *timer)
+{
+    uint32_t status = EVIC_disable_interrupts();
+    if(timer->active)
+        SWT_unlink(timer);
+    timer->active = false;
+    timer->pending = false;
+    EVIC_restore_interrupts(status);
+}
+
+bool        SWT_timer_is_active         (SWT_Timer *timer)
+{
+    return timer->active;
+}
+
+void        SWT_task                    (void)
+{
+    for(;;){
+        uint32_t status = EVIC_disable_interrupts();
+        SWT_Timer *timer = swtDeferredHead;
+        if(timer == NULL){
+            EVIC_restore_interrupts(status);
+            return;
+        }
+        swtDeferredHead = timer->deferredNext;
+        if(swtDeferredHead == NULL)
+            swtDeferredTail = NULL;
+        timer->queued = false;
+        bool run = timer->pending;
+        timer->pending = false;
+        EVIC_restore_interrupts(status);
+
+        if(run && timer->callback != NULL)
+            timer->callback(timer, timer->context);
+    }
+}
+
+static void SWT_tick(uint32_t channel, uintptr_t context)
+{
+    (void)channel;
+    (void)context;
+
+    uint32_t ticks = ++swtTicks;
+    SWT_Timer *timer = swtWheel[ticks & SWT_WHEEL_MASK];
+
+    /*swtNext is kept valid by SWT_unlink in case a callback stops the following timer*/
+    while(timer != NULL){
+        swtNext = timer->next;
+        if(timer->rounds != 0){
+            timer->rounds--;
+        }
+        else{
+            SWT_unlink(timer);
+            if(timer->flags & SWT_PERIODIC)
+                SWT_link(timer, timer->period);
+            else
+                timer->active = false;
+            SWT_expire(timer);
+        }
+        timer = swtNext;
+    }
+}
+
+static void SWT_link(SWT_Timer *timer, uint32_t ticks)
+{
+    uint32_t index = (swtTicks + ticks) & SWT_WHEEL_MASK;
+    SWT_Timer **slot = &swtWheel[index];
+
+    timer->slot = index;
+    timer->rounds = (ticks - 1) / SWT_WHEEL_SIZE;
+    timer->prev = NULL;
+    timer->next = *slot;
+    if(*slot != NULL)
+        (*slot)->prev = timer;
+    *slot = timer;
+}
+
+static void SWT_unlink(SWT_Timer *timer)
+{
+    if(swtNext == timer)
+        swtNext = timer->next;
+
+    if(timer->prev != NULL)
+        timer->prev->next = timer->next;
+    else
+        swtWheel[timer->slot] = timer->next;
+    if(timer->next != NULL)
+        timer->next->prev = timer->prev;
+    timer->next = timer->prev = NULL;
+}
+
+static void SWT_expire(SWT_Timer *timer)
+{
+    if((timer->flags & SWT_DEFERRED) == 0){
+        if(timer->callback != NULL)
+            timer->callback(timer, timer->context);
+        return;
+    }
+
+    timer->pending = true;
+    if(timer->queued)
+        return;
+    timer->queued = true;
+    timer->deferredNext = NULL;
+    if(swtDeferredTail != NULL)
+        swtDeferredTail->deferredNext = timer;
+    else
+        swtDeferredHead = timer;
+    swtDeferredTail = timer;
+}
@@ -0,0 +1,333 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "timer.h"
+#include "hal_family.h"
+#include "evic.h"
+#include <xc.h>
+#include "system.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+#define TMR_CLOCK_FREQUENCY()               (SYS_peripheral_clock_frequency_get(SYS_PERIPHERAL_CLOCK_3))
+/*In 32 bit mode the even timer holds the 32 bit count and period, the interrupt comes from the odd timer*/
+#define TMR_IRQ_CHANNEL(channel)            (halTmrIrqChannels[tmrObjects[channel].mode32 ? (channel) + 1 : (channel)])
+#define TMR_PRESCALER_GET(channel)          ((TMR_DESCRIPTOR(channel)->txcon.reg & _T2CON_TCKPS_MASK) >> _T2CON_TCKPS0_POSITION)
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    TMR_Callback    callback;
+    uintptr_t       context;
+    bool            mode32;
+    bool            interruptEnabled;
+    volatile bool   staged;
+    uint32_t        stagedPrescaler;
+    uint32_t        stagedPeriod;
+    /*Requested rate, re-solved when the peripheral clock changes, both 0 when the period was set in ticks*/
+    uint32_t        frequency;
+    uint64_t        periodNs;
+    bool            powered;
+}TMR_Object;
+
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static TMR_Object tmrObjects[TMR_NUMBER_OF_CHANNELS];
+static bool tmrClockNotifier;
+static const uint32_t prescalerTable[] = {
+    1,2,4,8,16,32,64,256
+};
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static bool TMR_solve(uint32_t channel, uint64_t num, uint64_t den, TMR_Solution *solution);
+static void TMR_configuration_update(uint32_t channel, uint32_t prescaler, uint32_t period);
+static void TMR_configuration_load(uint32_t channel, uint32_t prescaler, uint32_t period);
+static uint64_t TMR_gcd(uint64_t a, uint64_t b);
+static void TMR_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context);
+static void TMR_power(uint32_t channel, bool on);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+void        TMR_initialize(uint32_t channel, uint32_t flags, uint32_t period)
+{
+    bool wasPair = tmrObjects[channel].mode32;
+    /*Only the even timer of a pair (TMR_CHANNEL_23, 45, 67, 89) can run in 32 bit mode*/
+    tmrObjects[channel].mode32 = (flags & TMR_MODE_32) && (channel & 1) == 0 && channel + 1 < TMR_NUMBER_OF_CHANNELS;
+    TMR_power(channel, true);
+    if(tmrObjects[channel].mode32)
+        TMR_power(channel + 1, true);
+    else if(wasPair)
+        TMR_power(channel + 1, false);
+
+    TMR_DESCRIPTOR(channel)->txcon.reg = 0;
+    TMR_DESCRIPTOR(channel)->txcon.set = (TMR_TCKPS_MASK & flags) << _T1CON_TCKPS0_POSITION;
+    if(flags & TMR_GATED)
+        TMR_DESCRIPTOR(channel)->txcon.set = _T2CON_TGATE_MASK;
+    else if(flags & TMR_EXTERNAL_SOURCE)
+        TMR_DESCRIPTOR(channel)->txcon.set = _T2CON_TCS_MASK;
+    if(tmrObjects[channel].mode32){
+        /*The odd timer is switched off and only provides the interrupt*/
+        TMR_DESCRIPTOR(channel + 1)->txcon.reg = 0;
+        TMR_DESCRIPTOR(channel)->txcon.set = _T2CON_T32_MASK;
+    }
+
+    TMR_DESCRIPTOR(channel)->tmrx.reg = 0;
+    TMR_DESCRIPTOR(channel)->prx.reg = period;
+    tmrObjects[channel].frequency = 0;
+    tmrObjects[channel].periodNs = 0;
+
+    if(!tmrClockNotifier)
+        tmrClockNotifier = SYS_clock_notifier_register(TMR_clock_changed, 0);
+}
+void        TMR_deinitialize(uint32_t channel)
+{
+    TMR_interrupt_set(channel, false);
+    TMR_DESCRIPTOR(channel)->txcon.reg = 0;
+    tmrObjects[channel].staged = false;
+    tmrObjects[channel].frequency = 0;
+    tmrObjects[channel].periodNs = 0;
+    if(tmrObjects[channel].mode32){
+        tmrObjects[channel].mode32 = false;
+        TMR_power(channel + 1, false);
+    }
+    TMR_power(channel, false);
+}
+void        TMR_start(uint32_t channel)
+{
+    TMR_DESCRIPTOR(channel)->tmrx.reg = 0;
+    TMR_DESCRIPTOR(channel)->txcon.set = _T2CON_ON_MASK;
+}
+void        TMR_stop(uint32_t channel)
+{
+    TMR_DESCRIPTOR(channel)->txcon.clr = _T2CON_ON_MASK;
+}
+uint32_t    TMR_count_get(uint32_t channel)
+{
+    return TMR_DESCRIPTOR(channel)->tmrx.reg;
+}
+uint32_t    TMR_period_get(uint32_t channel)
+{
+    return TMR_DESCRIPTOR(channel)->prx.reg;
+}
+uint32_t    TMR_frequency_get(uint32_t channel)
+{
+    uint64_t ticks = ((uint64_t)TMR_DESCRIPTOR(channel)->prx.reg + 1) * prescalerTable[TMR_PRESCALER_GET(channel)];
+    return TMR_CLOCK_FREQUENCY() / ticks;
+}
+uint32_t    TMR_tick_frequency_get(uint32_t channel)
+{
+    return TMR_CLOCK_FREQUENCY() / prescalerTable[TMR_PRESCALER_GET(channel)];
+}
+
+void        TMR_interrupt_handler(uint32_t channel)
+{
+    /*The odd timer ISR of a 32 bit pair serves the even timer object*/
+    if((channel & 1) && tmrObjects[channel - 1].mode32)
+        channel--;
+    EVIC_channel_pending_clear(TMR_IRQ_CHANNEL(channel));
+    /*The counter has just been reset, a staged configuration takes effect from this period*/
+    if(tmrObjects[channel].staged){
+        tmrObjects[channel].staged = false;
+        TMR_configuration_load(channel, tmrObjects[channel].stagedPrescaler, tmrObjects[channel].stagedPeriod);
+    }
+    if(tmrObjects[channel].callback != NULL)
+        tmrObjects[channel].callback(channel, tmrObjects[channel].context);
+    else
+        TMR_channel_interrupt_callback(channel);
+}
+HAL_WEAK_FUNCTION void TMR_channel_interrupt_callback     (uint32_t channel)
+{
+    (void)channel;
+}
+void        TMR_callback_register(uint32_t channel, TMR_Callback callback, uintptr_t context)
+{
+    tmrObjects[channel].callback = callback;
+    tmrObjects[channel].context = context;
+}
+void        TMR_interrupt_set(uint32_t channel, bool state)
+{
+    EVIC_channel_pending_clear(TMR_IRQ_CHANNEL(channel));
+    tmrObjects[channel].interruptEnabled = state;
+    if(state)
+        EVIC_channel_set(TMR_IRQ_CHANNEL(channel));
+    else
+        EVIC_channel_clr(TMR_IRQ_CHANNEL(channel));
+}
+uint32_t    TMR_irq_channel_get(uint32_t channel)
+{
+    return TMR_IRQ_CHANNEL(channel);
+}
+bool        TMR_is_32bit(uint32_t channel)
+{
+    return tmrObjects[channel].mode32;
+}
+void        TMR_period_set(uint32_t channel, uint32_t period)
+{
+    tmrObjects[channel].frequency = 0;
+    tmrObjects[channel].periodNs = 0;
+    TMR_configuration_update(channel, TMR_PRESCALER_GET(channel), period);
+}
+void        TMR_period_load(uint32_t channel, uint32_t period)
+{
+    /*Loads the period right away, for the timer callback where the counter has just been reset on the match*/
+    tmrObjects[channel].frequency = 0;
+    tmrObjects[channel].periodNs = 0;
+    tmrObjects[channel].staged = false;
+    TMR_configuration_load(channel, TMR_PRESCALER_GET(channel), period);
+}
+void        TMR_prescaler_set(uint32_t channel, uint16_t prescaler)
+{
+    tmrObjects[channel].frequency = 0;
+    tmrObjects[channel].periodNs = 0;
+    TMR_configuration_update(channel, prescaler & TMR_TCKPS_MASK, TMR_DESCRIPTOR(channel)->prx.reg);
+}
+uint32_t    TMR_frequency_set(uint32_t channel, uint32_t frequency)
+{
+    TMR_Solution solution;
+    if(!TMR_frequency_solve(channel, frequency, &solution))
+        return 0;
+    TMR_solution_apply(channel, &solution);
+    tmrObjects[channel].frequency = frequency;
+    tmrObjects[channel].periodNs = 0;
+    return solution.frequency;
+}
+uint32_t    TMR_period_ns_set(uint32_t channel, uint64_t periodNs)
+{
+    TMR_Solution solution;
+    if(!TMR_period_ns_solve(channel, periodNs, &solution))
+        return 0;
+    TMR_solution_apply(channel, &solution);
+    tmrObjects[channel].frequency = 0;
+    tmrObjects[channel].periodNs = periodNs;
+    return solution.frequency;
+}
+bool        TMR_frequency_solve(uint32_t channel, uint32_t frequency, TMR_Solution *solution)
+{
+    if(frequency == 0)
+        return false;
+    return TMR_solve(channel, TMR_CLOCK_FREQUENCY(), frequency, solution);
+}
+bool        TMR_period_ns_solve(uint32_t channel, uint64_t periodNs, TMR_Solution *solution)
+{
+    uint64_t clock = TMR_CLOCK_FREQUENCY();
+    uint64_t g = TMR_gcd(clock, 1000000000ULL);
+
+    /*Clock ticks per period is clock * ns / 1e9, reduced so the product does not overflow*/
+    if(periodNs == 0 || periodNs > UINT64_MAX / (clock / g))
+        return false;
+    return TMR_solve(channel, (clock / g) * periodNs, 1000000000ULL / g, solution);
+}
+void        TMR_solution_apply(uint32_t channel, const TMR_Solution *solution)
+{
+    TMR_configuration_update(channel, solution->prescaler, solution->period);
+}
+
+/*Picks the prescaler and period whose period in clock ticks (prescaler * (PR + 1)) is closest to num / den,
+ the smallest prescaler wins ties as it gives the finest duty resolution.*/
+static bool TMR_solve(uint32_t channel, uint64_t num, uint64_t den, TMR_Solution *solution)
+{
+    uint64_t maxTicks = tmrObjects[channel].mode32 ? 0x100000000ULL : 0x10000ULL;
+    uint64_t bestError = UINT64_MAX;
+    uint64_t bestTotal = 0;
+
+    for(uint32_t i = 0; i < sizeof(prescalerTable)/sizeof(prescalerTable[0]); i++){
+        uint64_t step = den * prescalerTable[i];
+        uint64_t ticks = (num + step / 2) / step;
+        if(ticks < 2 || ticks > maxTicks)
+            continue;
+
+        uint64_t total = ticks * step;
+        uint64_t error = total > num ? total - num : num - total;
+        if(error < bestError){
+            bestError = error;
+            bestTotal = total;
+            solution->prescaler = i;
+            solution->period = ticks - 1;
+        }
+    }
+    if(bestError == UINT64_MAX)
+        return false;
+
+    uint64_t ticks = ((uint64_t)solution->period + 1) * prescalerTable[solution->prescaler];
+    solution->frequency = TMR_CLOCK_FREQUENCY() / ticks;
+    /*Relative error of the achieved period, positive when the period is longer than requested*/
+    int64_t ppm = num >= 1000000 ? (int64_t)(bestError / (num / 1000000)) : (int64_t)((bestError * 1000000) / num);
+    solution->errorPpm = bestTotal >= num ? ppm : -ppm;
+    return true;
+}
+
+static void TMR_configuration_update(uint32_t channel, uint32_t prescaler, uint32_t period)
+{
+    TMR_Object *obj = &tmrObjects[channel];
+
+    /*A running timer with its interrupt enabled is updated on the next period match so no period is cut short*/
+    if((TMR_DESCRIPTOR(channel)->txcon.reg & _T2CON_ON_MASK) && obj->interruptEnabled){
+        uint32_t status = EVIC_disable_interrupts();
+        obj->stagedPrescaler = prescaler;
+        obj->stagedPeriod = period;
+        obj->staged = true;
+        EVIC_restore_interrupts(status);
+        return;
+    }
+    TMR_configuration_load(channel, prescaler, period);
+}
+
+static void TMR_configuration_load(uint32_t channel, uint32_t prescaler, uint32_t period)
+{
+    TMR_Descriptor tmr = TMR_DESCRIPTOR(channel);
+    uint32_t tckps = (prescaler & TMR_TCKPS_MASK) << _T2CON_TCKPS0_POSITION;
+    bool on = (tmr->txcon.reg & _T2CON_ON_MASK) != 0;
+
+    /*The prescaler must not change while the timer runs*/
+    if((tmr->txcon.reg & _T2CON_TCKPS_MASK) != tckps){
+        if(on)
+            tmr->txcon.clr = _T2CON_ON_MASK;
+        tmr->txcon.clr = _T2CON_TCKPS_MASK;
+        tmr->txcon.set = tckps;
+    }
+    tmr->prx.reg = period;
+    /*A counter already past the new period would otherwise run up to the overflow*/
+    if(tmr->tmrx.reg > period)
+        tmr->tmrx.reg = 0;
+    if(on)
+        tmr->txcon.set = _T2CON_ON_MASK;
+}
+
+static uint64_t TMR_gcd(uint64_t a, uint64_t b)
+{
+    while(b != 0){
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/*Timers set by frequency or period keep their rate, timers set in raw ticks are left alone*/
+static void TMR_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context)
+{
+    for(uint32_t channel = 0; channel < TMR_NUMBER_OF_CHANNELS; channel++){
+        if(tmrObjects[channel].frequency != 0)
+            TMR_frequency_set(channel, tmrObjects[channel].frequency);
+        else if(tmrObjects[channel].periodNs != 0)
+            TMR_period_ns_set(channel, tmrObjects[channel].periodNs);
+    }
+}
+
+static void TMR_power(uint32_t channel, bool on)
+{
+    if(tmrObjects[channel].powered == on)
+        return;
+    tmrObjects[channel].powered = on;
+    if(on)
+        SYS_pmd_acquire(SYS_PMD_TMR(channel));
+    else
+        SYS_pmd_release(SYS_PMD_TMR(channel));
+}
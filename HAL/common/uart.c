@@ -14,7 +14,7 @@
 **********************************************************************/
 #include <xc.h>
 #include "uart.h"
-#include "pic32mx_registers.h"
+#include "hal_family.h"
 #include "evic.h"
 #include "system.h"
 #include "hal_ring_buffer.h"
@@ -22,16 +22,13 @@
 /**********************************************************************
 * Module Preprocessor Constants
 **********************************************************************/
-#define UART_BASE                               _UART1_BASE_ADDRESS
-#define UART_NUMBER_OF_CHANNELS                 (6)
-#define UART_PERIPHERAL_INTERVAL                (0x200)
+
 /**********************************************************************
 * Module Preprocessor Macros
 **********************************************************************/
-#define UART_DESCRIPTOR(channel)                (descriptors[channel])
-#define UART_RX_INTERRUPT_CHANNEL(channel)      (uartIRQBase[channel] + 1)
-#define UART_TX_INTERRUPT_CHANNEL(channel)      (uartIRQBase[channel] + 2)
-#define UART_FAULT_INTERRUPT_CHANNEL(channel)   (uartIRQBase[channel])
+#define UART_RX_INTERRUPT_CHANNEL(channel)      (halUartIrqBase[channel] + 1)
+#define UART_TX_INTERRUPT_CHANNEL(channel)      (halUartIrqBase[channel] + 2)
+#define UART_FAULT_INTERRUPT_CHANNEL(channel)   (halUartIrqBase[channel])
 /**********************************************************************
 * Module Typedefs
 **********************************************************************/
@@ -50,32 +47,20 @@ typedef struct{
     UART_Callback   callback;
     uintptr_t       context;
     RingBuffer      rxBuffer;
+    int             baudrate;
+    bool            powered;
 }UART_Object;
 /*********************************************************************
 * Module Variable Definitions
 **********************************************************************/
 static UART_Object uartObjects[UART_NUMBER_OF_CHANNELS];
-static const EVIC_CHANNEL uartIRQBase[UART_NUMBER_OF_CHANNELS]={
-        EVIC_CHANNEL_UART1_ERR,
-        EVIC_CHANNEL_UART2_ERR,
-        EVIC_CHANNEL_UART3_ERR,
-        EVIC_CHANNEL_UART4_ERR,
-        EVIC_CHANNEL_UART5_ERR,
-        EVIC_CHANNEL_UART6_ERR,
-};
-static const UART_Descriptor descriptors[]={
-        [UART_CHANNEL_1] = (UART_Descriptor)&U1MODE,
-        [UART_CHANNEL_2] = (UART_Descriptor)&U2MODE,
-        [UART_CHANNEL_3] = (UART_Descriptor)&U3MODE,
-        [UART_CHANNEL_4] = (UART_Descriptor)&U4MODE,
-        [UART_CHANNEL_5] = (UART_Descriptor)&U5MODE,
-        [UART_CHANNEL_6] = (UART_Descriptor)&U6MODE,
-};
+static bool uartClockNotifier;
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
 static int UART_baudrate(UART_Channel channel, int baudrate);
 static void  UART_error_clear(UART_Channel channel);
+static void  UART_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context);
 /**********************************************************************
 * Function Definitions
 **********************************************************************/
@@ -95,6 +80,10 @@ static void  UART_error_clear(UART_Channel channel);
 
 int     UART_initialize(UART_Channel channel, UART_Flags flags, int baudrate, uint8_t *rxBuffer, size_t bufferSize)
 {
+    if(!uartObjects[channel].powered){
+        SYS_pmd_acquire(SYS_PMD_UART(channel));
+        uartObjects[channel].powered = true;
+    }
     EVIC_channel_clr(UART_FAULT_INTERRUPT_CHANNEL(channel));
     EVIC_channel_clr(UART_RX_INTERRUPT_CHANNEL(channel));
     EVIC_channel_clr(UART_TX_INTERRUPT_CHANNEL(channel));
@@ -107,8 +96,33 @@ int     UART_initialize(UART_Channel channel, UART_Flags flags, int baudrate, ui
 
     UART_DESCRIPTOR(channel)->umode.set = _U1MODE_ON_MASK;
 
+    if(!uartClockNotifier)
+        uartClockNotifier = SYS_clock_notifier_register(UART_clock_changed, 0);
+
     return 0;
 }
+void    UART_deinitialize(UART_Channel channel)
+{
+    EVIC_channel_clr(UART_FAULT_INTERRUPT_CHANNEL(channel));
+    EVIC_channel_clr(UART_RX_INTERRUPT_CHANNEL(channel));
+    EVIC_channel_clr(UART_TX_INTERRUPT_CHANNEL(channel));
+    UART_DESCRIPTOR(channel)->umode.reg = 0;
+    uartObjects[channel].txBusy = false;
+    uartObjects[channel].rxBusy = false;
+    uartObjects[channel].baudrate = 0;
+    if(uartObjects[channel].powered){
+        uartObjects[channel].powered = false;
+        SYS_pmd_release(SYS_PMD_UART(channel));
+    }
+}
+/*A falling edge on RX wakes the core from Sleep, WAKE clears itself on the next start bit*/
+void    UART_wake_enable(UART_Channel channel, bool enable)
+{
+    if(enable)
+        UART_DESCRIPTOR(channel)->umode.set = _U1MODE_WAKE_MASK;
+    else
+        UART_DESCRIPTOR(channel)->umode.clr = _U1MODE_WAKE_MASK;
+}
 int     UART_setup(UART_Channel channel, UART_Flags flags, int baudrate)
 {
     UART_DESCRIPTOR(channel)->umode.reg = 0;
@@ -116,6 +130,7 @@ int     UART_setup(UART_Channel channel, UART_Flags flags, int baudrate)
     if(brg < 0)
         return -1;
     UART_DESCRIPTOR(channel)->ubrg.reg = brg;
+    uartObjects[channel].baudrate = baudrate;
 
     if((flags & UART_PARITY_EVEN) == UART_PARITY_EVEN)
         UART_DESCRIPTOR(channel)->umode.set = _U1MODE_PDSEL0_MASK;
@@ -258,7 +273,7 @@ bool    UART_write_isr(UART_Channel channel, uint8_t *txBuffer, size_t size)
     return true;
 }
 
-static void UART_rx_interrupt_handler (UART_Channel channel)
+void UART_rx_interrupt_handler (UART_Channel channel)
 {
     /* Keep reading until there is a character availabe in the RX FIFO */
     while((UART_DESCRIPTOR(channel)->usta.reg & _U1STA_URXDA_MASK) == _U1STA_URXDA_MASK)
@@ -280,10 +295,10 @@ static void UART_rx_interrupt_handler (UART_Channel channel)
     /* Clear UART3 RX Interrupt flag */
     EVIC_channel_pending_clear(UART_RX_INTERRUPT_CHANNEL(channel));
 }
-static void UART_fault_interrupt_handler (UART_Channel channel)
+void UART_fault_interrupt_handler (UART_Channel channel)
 {
     /* Save the error to be reported later */
-    uartObjects[channel].error = (UART_ERROR)(U3STA & (_U3STA_OERR_MASK | _U3STA_FERR_MASK | _U3STA_PERR_MASK));
+    uartObjects[channel].error = (UART_ERROR)(UART_DESCRIPTOR(channel)->usta.reg & (_U1STA_OERR_MASK | _U1STA_FERR_MASK | _U1STA_PERR_MASK));
 
     UART_error_clear(channel);
 
@@ -294,6 +309,7 @@ static void UART_fault_interrupt_handler (UART_Channel channel)
     }
 }
 
+/*For parts where RX, TX and fault share one vector*/
 void UART_interrupt_handler (UART_Channel channel)
 {
     if(EVIC_channel_pending_get(UART_RX_INTERRUPT_CHANNEL(channel)) &&
@@ -366,4 +382,17 @@ static int UART_baudrate(UART_Channel channel, int baudrate){
     if(brg > 65535)
         return -1;
     return brg;
-}
\ No newline at end of file
+}
+
+/*The BRG divides PBCLK2, so every configured channel gets its divider recomputed*/
+static void  UART_clock_changed(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context)
+{
+    for(UART_Channel channel = 0; channel < UART_NUMBER_OF_CHANNELS; channel++){
+        if(uartObjects[channel].baudrate == 0)
+            continue;
+        UART_DESCRIPTOR(channel)->umode.clr = _U1MODE_BRGH_MASK;
+        int brg = UART_baudrate(channel, uartObjects[channel].baudrate);
+        if(brg >= 0)
+            UART_DESCRIPTOR(channel)->ubrg.reg = brg;
+    }
+}
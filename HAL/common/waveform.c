@@ -0,0 +1,179 @@
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "waveform.h"
+#include "hal_family.h"
+#include "timer.h"
+#include "dma.h"
+/**********************************************************************
+* Module Preprocessor Constants
+**********************************************************************/
+/**********************************************************************
+* Module Preprocessor Macros
+**********************************************************************/
+#define WAVE_TARGET_ADDRESS(port, flags)    ((uint32_t)(((volatile uint32_t*)&GPIO_get_descriptor(port)->lat) + ((flags) & WAVE_TARGET_MASK)))
+/**********************************************************************
+* Module Typedefs
+**********************************************************************/
+typedef struct{
+    bool            busy;
+    GPIO_Port       port;
+    uint32_t        tmrChannel;
+    uint32_t        flags;
+    WAVE_Callback   callback;
+    uintptr_t       context;
+}WAVE_Object;
+/*********************************************************************
+* Module Variable Definitions
+**********************************************************************/
+static WAVE_Object waveObjects[DMA_NUMBER_OF_CHANNELS];
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+static void WAVE_dma_callback(DMA_Channel channel, DMA_IRQ_CAUSE cause, uintptr_t context);
+/**********************************************************************
+* Function Definitions
+**********************************************************************/
+int         WAVE_initialize             (DMA_Channel dmaChannel, uint32_t tmrChannel, GPIO_Port port, uint32_t flags, uint32_t frequency)
+{
+    if(dmaChannel >= DMA_NUMBER_OF_CHANNELS || frequency == 0)
+        return -1;
+
+    WAVE_Object *obj = &waveObjects[dmaChannel];
+    obj->busy = false;
+    obj->port = port;
+    obj->tmrChannel = tmrChannel;
+    obj->flags = flags;
+
+    TMR_initialize(tmrChannel, TMR_PRESCALER_1, 0);
+    TMR_frequency_set(tmrChannel, frequency);
+
+    if(flags & WAVE_REPEAT)
+        DMA_channel_init(dmaChannel, DMA_CHANNEL_PRIORITY_3 | DMA_CHANNEL_START_IRQ | DMA_CHANNEL_AUTO_ENABLE);
+    else
+        DMA_channel_init(dmaChannel, DMA_CHANNEL_PRIORITY_3 | DMA_CHANNEL_START_IRQ);
+    DMA_callback_register(dmaChannel, WAVE_dma_callback, 0);
+    return 0;
+}
+
+bool        WAVE_start                  (DMA_Channel dmaChannel, const uint16_t *words, size_t count)
+{
+    WAVE_Object *obj = &waveObjects[dmaChannel];
+
+    if(obj->busy || words == NULL || count == 0 || count * sizeof(uint16_t) > DMA_MAX_TRANSFER_SIZE)
+        return false;
+
+    obj->busy = true;
+    TMR_stop(obj->tmrChannel);
+
+    DMA_CHANNEL_Config dmaConfig = {
+            .startIrq = TMR_irq_channel_get(obj->tmrChannel),
+            .cellSize = sizeof(uint16_t),
+            .dstSize = sizeof(uint16_t),
+            .dstAddress = WAVE_TARGET_ADDRESS(obj->port, obj->flags),
+            .srcSize = count * sizeof(uint16_t),
+            .srcAddress = (uint32_t)words,
+    };
+    DMA_channel_config(dmaChannel, &dmaConfig);
+    DMA_channel_enable(dmaChannel);
+
+    /*Every period match of the timer moves one word into the port*/
+    TMR_start(obj->tmrChannel);
+    return true;
+}
+
+void        WAVE_stop                   (DMA_Channel dmaChannel)
+{
+    WAVE_Object *obj = &waveObjects[dmaChannel];
+
+    DMA_channel_abort(dmaChannel);
+    TMR_stop(obj->tmrChannel);
+    obj->busy = false;
+}
+
+bool        WAVE_is_busy                (DMA_Channel dmaChannel)
+{
+    return waveObjects[dmaChannel].busy;
+}
+
+void        WAVE_callback_register      (DMA_Channel dmaChannel, WAVE_Callback callback, uintptr_t context)
+{
+    waveObjects[dmaChannel].callback = callback;
+    waveObjects[dmaChannel].context = context;
+}
+
+size_t      WAVE_ws2812_encode          (uint16_t *words, size_t size, const uint8_t *data, size_t length, uint16_t pinMask)
+{
+    return WAVE_ws2812_encode_lanes(words, size, &data, &pinMask, 1, length);
+}
+
+size_t      WAVE_ws2812_encode_lanes    (uint16_t *words, size_t size, const uint8_t * const *lanes, const uint16_t *pinMasks,
+                                         size_t laneCount, size_t length)
+{
+    size_t count = 0;
+    uint16_t allMask = 0;
+
+    if(size < length * WAVE_WS2812_WORDS_PER_BYTE)
+        return 0;
+
+    for(size_t lane = 0; lane < laneCount; lane++)
+        allMask |= pinMasks[lane];
+
+    /*Every bit is three slots: HIGH, DATA, LOW. A '0' is high for one slot, a '1' for two.*/
+    for(size_t i = 0; i < length; i++){
+        for(uint8_t bit = 0x80; bit != 0; bit >>= 1){
+            uint16_t ones = 0;
+            for(size_t lane = 0; lane < laneCount; lane++){
+                if(lanes[lane][i] & bit)
+                    ones |= pinMasks[lane];
+            }
+            words[count++] = allMask;
+            words[count++] = ones;
+            words[count++] = 0;
+        }
+    }
+    return count;
+}
+
+size_t      WAVE_parallel_encode        (uint16_t *words, size_t size, const uint8_t *data, size_t length,
+                                         uint32_t dataShift, uint16_t strobeMask, bool strobeActiveLow)
+{
+    size_t count = 0;
+    uint16_t active = strobeActiveLow ? 0 : strobeMask;
+    uint16_t idle = strobeActiveLow ? strobeMask : 0;
+
+    if(size < length * WAVE_PARALLEL_WORDS_PER_BYTE)
+        return 0;
+
+    /*Data is presented with the strobe asserted and latched by the device on the strobe release*/
+    for(size_t i = 0; i < length; i++){
+        uint16_t value = (uint16_t)(data[i] << dataShift);
+        words[count++] = value | active;
+        words[count++] = value | idle;
+    }
+    return count;
+}
+
+void        WAVE_levels_to_toggles      (uint16_t *words, size_t count, uint16_t initial)
+{
+    uint16_t previous = initial;
+    for(size_t i = 0; i < count; i++){
+        uint16_t level = words[i];
+        words[i] = level ^ previous;
+        previous = level;
+    }
+}
+
+static void WAVE_dma_callback(DMA_Channel channel, DMA_IRQ_CAUSE cause, uintptr_t context)
+{
+    (void)context;
+    WAVE_Object *obj = &waveObjects[channel];
+
+    if(cause != DMA_IRQ_CAUSE_TRANSFER_COMPLETE || (obj->flags & WAVE_REPEAT) == 0){
+        TMR_stop(obj->tmrChannel);
+        obj->busy = false;
+    }
+    if(obj->callback != NULL)
+        obj->callback(channel, obj->context);
+}
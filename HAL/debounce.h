@@ -0,0 +1,45 @@
+/**
+ * @file debounce.h
+ * @brief Software debouncer for change notice inputs. The first edge of a pin disables its change notice,
+ * the pin is then re-sampled from a timer tick and a single event is delivered once it is stable.
+ */
+
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "gpio.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#ifndef DEBOUNCE_MAX_PINS
+#define DEBOUNCE_MAX_PINS                   (16)
+#endif
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef void (*DEBOUNCE_Callback)(GPIO_PinMap pin, bool state, uintptr_t context);
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         DEBOUNCE_initialize         (uint32_t tmrChannel, uint32_t tickUs);
+int         DEBOUNCE_pin_register       (GPIO_PinMap pin, uint32_t debounceMs, DEBOUNCE_Callback callback, uintptr_t context);
+void        DEBOUNCE_pin_unregister     (GPIO_PinMap pin);
+bool        DEBOUNCE_pin_state_get      (GPIO_PinMap pin);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //DEBOUNCE_H
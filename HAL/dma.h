@@ -32,6 +32,8 @@
 #define DMA_CHANNEL_CHAIN_LOWER                             (0x0010)
 #define DMA_CHANNEL_CHAIN_UPPER                             (0x0020)
 #define DMA_CHANNEL_CHAINED                                 (0x0040)
+#define DMA_CHANNEL_AUTO_ENABLE                             (0x0080)
+#define DMA_CHANNEL_SOURCE_HALF_IRQ                         (0x0100)
 /**********************************************************************
 * Typedefs
 **********************************************************************/
@@ -51,7 +53,8 @@ typedef struct{
 typedef enum{
     DMA_IRQ_CAUSE_TRANSFER_COMPLETE,
     DMA_IRQ_CAUSE_ABORT,
-    DMA_IRQ_CAUSE_ERROR
+    DMA_IRQ_CAUSE_ERROR,
+    DMA_IRQ_CAUSE_SOURCE_HALF_EMPTY
 }DMA_IRQ_CAUSE;
 
 typedef void (*DMA_Callback)(DMA_Channel, DMA_IRQ_CAUSE, uintptr_t);
@@ -64,9 +67,15 @@ extern "C"{
 #endif
 
 int DMA_init();
+void DMA_deinit();
 int DMA_channel_init(DMA_Channel channel, int configFlags);
 int DMA_channel_config(DMA_Channel channel, DMA_CHANNEL_Config *config);
 int DMA_channel_transfer(DMA_Channel channel);
+int DMA_channel_enable(DMA_Channel channel);
+int DMA_channel_abort(DMA_Channel channel);
+bool DMA_channel_is_busy(DMA_Channel channel);
+bool DMA_is_active(void);
+uint32_t DMA_channel_destination_pointer_get(DMA_Channel channel);
 void DMA_callback_register(DMA_Channel channel, DMA_Callback callback, uintptr_t context);
 
 #ifdef __cplusplus
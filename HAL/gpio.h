@@ -43,6 +43,8 @@
 #define GPIO_FAST                   (0x0080)
 #define GPIO_FASTEST                (0x0100)
 #define GPIO_IRQ                    (0x0200)
+/*Outputs start high, LAT is written before the pin is driven*/
+#define GPIO_INIT_HIGH              (0x0400)
 
 #define GPIO_INPUT_PULLUP           (GPIO_PULLUP)
 #define GPIO_INPUT_PULLDOWN         (GPIO_PULLDOWN)
@@ -72,10 +74,18 @@
 
 #define GPIO_LOW                    (0)
 #define GPIO_HIGH                   (1)
+
+/*Services listening to change notices of the same port*/
+#define GPIO_CALLBACKS_PER_PORT     (4)
+
+#define GPIO_GROUP_MAX_PINS         (32)
+#define GPIO_GROUP_MAX_PORTS        (GPIO_PORT_K + 1)
 /*********************************************************************
 * Preprocessor Macros
 **********************************************************************/
 #define GPIO_PIN_MAP(port, pin)     ((port << GPIO_PORT_SHIFT) | pin)
+#define GPIO_PIN_CONFIG(pin, flags)                     {(pin), (flags), NULL, 0}
+#define GPIO_PIN_CONFIG_PPS(pin, flags, reg, function)  {(pin), (flags), (reg), (function)}
 /**********************************************************************
 * Typedefs
 **********************************************************************/
@@ -96,6 +106,22 @@ typedef struct{
     uintptr_t context;
 }GPIO_CALLBACK_OBJECT;
 
+/*Pins spread over several ports, updated through the LAT SET/CLR/INV registers one port at a time*/
+typedef struct{
+    GPIO_PinMap pins[GPIO_GROUP_MAX_PINS];
+    uint32_t count;
+    uint16_t masks[GPIO_GROUP_MAX_PORTS];
+}GPIO_Group;
+
+/*One entry of a board pin table. ppsRegister is a PPS_INPUT_REG_x or PPS_OUTPUT_REG_x, NULL when the pin is not
+ remapped*/
+typedef struct{
+    GPIO_PinMap         pin;
+    uint32_t            flags;
+    volatile uint32_t   *ppsRegister;
+    uint32_t            ppsFunction;
+}GPIO_PinConfig;
+
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
@@ -108,14 +134,29 @@ void        GPIO_pin_deinitialize           (GPIO_PinMap pin);
 bool        GPIO_pin_read                   (GPIO_PinMap pin);
 void        GPIO_pin_write                  (GPIO_PinMap pin, bool value);
 void        GPIO_pin_toggle                 (GPIO_PinMap pin);
+/*Enabling a pin also switches the change notice module of its port on*/
 void        GPIO_pin_interrupt_set          (GPIO_PinMap pin, bool state);
+/*Sets every listed pin to exactly its flags with one write per register and port, PPS under a single unlock*/
+void        GPIO_pin_table_apply            (const GPIO_PinConfig *table, size_t count);
 
 void        GPIO_port_write                 (GPIO_Port port, uint32_t value, uint32_t mask);
+void        GPIO_port_modify                (GPIO_Port port, uint32_t setMask, uint32_t clrMask);
 uint32_t    GPIO_port_read                  (GPIO_Port port, uint32_t mask);
 void        GPIO_port_toggle                (GPIO_Port port, uint32_t mask);
 
+int         GPIO_group_initialize           (GPIO_Group *group, const GPIO_PinMap *pins, size_t count, int flags);
+void        GPIO_group_set                  (const GPIO_Group *group);
+void        GPIO_group_clear                (const GPIO_Group *group);
+void        GPIO_group_toggle               (const GPIO_Group *group);
+void        GPIO_group_write                (const GPIO_Group *group, uint32_t value);
+uint32_t    GPIO_group_read                 (const GPIO_Group *group);
+
 void        GPIO_pin_interrupt_callback     (GPIO_PinMap pin);
 void        GPIO_interrupt_handler          (GPIO_Port port);
+/*Every callback of the port is called with all pins that changed, registering the same pair twice is a no-op.
+ GPIO_pin_interrupt_callback is still called after them*/
+int         GPIO_callback_register          (GPIO_Port port, GPIO_Callback callback, uintptr_t context);
+void        GPIO_callback_unregister        (GPIO_Port port, GPIO_Callback callback, uintptr_t context);
 
 
 #ifdef __cplusplus
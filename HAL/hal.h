@@ -21,17 +21,32 @@
 #include <stdbool.h>
 
 #include "hal_delay.h"
+#if defined(__PIC32MZ__)
+#include "adc.h"
+#include "cache.h"
+#endif
+#include "debounce.h"
 #include "dma.h"
 #include "evic.h"
 #include "gpio.h"
 #include "hal_delay.h"
 #include "hal_ring_buffer.h"
+#include "hal_time.h"
+#include "i2c.h"
+#include "ic.h"
+#include "keypad.h"
+#include "logic_analyzer.h"
 #include "oc.h"
+#include "perf.h"
 #include "pps.h"
+#include "pwm.h"
 #include "spi.h"
+#include "stepper.h"
+#include "sw_timer.h"
 #include "system.h"
 #include "timer.h"
 #include "uart.h"
+#include "waveform.h"
 
 /**********************************************************************
 * Preprocessor Constants
@@ -11,9 +11,17 @@
 **********************************************************************/
 #define MICRO_SECONDS               (1000000)
 #define MILLI_SECONDS               (1000)
+/*Idle delays shorter than this just spin, entering and leaving Idle costs more than it saves*/
+#ifndef HAL_DELAY_IDLE_MIN_US
+#define HAL_DELAY_IDLE_MIN_US       (20)
+#endif
 /**********************************************************************
 * Typedefs
 **********************************************************************/
+/*Deadline on the HAL_time base, polled with HAL_delay_elapsed or waited on with HAL_delay_idle_until*/
+typedef struct{
+    uint64_t    deadline;
+}HAL_Delay;
 
 /**********************************************************************
 * Function Prototypes
@@ -25,6 +33,18 @@ extern "C"{
 void HAL_delay_ms(uint32_t ms);
 void HAL_delay_us(uint32_t us);
 void HAL_delay_cy(uint32_t cy);
+/*Called by SYS_clock_set, the core timer always runs at SYSCLK/2*/
+void HAL_delay_clock_update(uint32_t systemClock);
+
+void HAL_delay_start(HAL_Delay *delay, uint32_t us);
+void HAL_delay_start_ms(HAL_Delay *delay, uint32_t ms);
+bool HAL_delay_elapsed(const HAL_Delay *delay);
+uint32_t HAL_delay_remaining_us(const HAL_Delay *delay);
+
+/*Idle delays need HAL_time_initialize and the core timer ISR, any other interrupt wakes the core early and it goes back to Idle*/
+void HAL_delay_idle_until(const HAL_Delay *delay);
+void HAL_delay_idle_ms(uint32_t ms);
+void HAL_delay_idle_us(uint32_t us);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,67 @@
+/**
+ * @file hal_time.h
+ * @brief Tickless time base and deadline scheduler on the CP0 Count/Compare pair. Count is extended to 64 bits
+ * and Compare is only programmed for the earliest pending deadline, so nothing wakes the CPU when nothing is due.
+ * HAL_time_interrupt_handler must be called from the core timer ISR. Tick values are only comparable while the system
+ * clock stays the same, pending deadlines are rescaled on a clock change and HAL_time_now_ns stays continuous.
+ */
+
+#ifndef HAL_TIME_H
+#define HAL_TIME_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+/*CP0 Count runs at half the system clock, which can change at run time with SYS_clock_set*/
+#define HAL_TIME_FREQUENCY                  (HAL_time_frequency_get())
+#define HAL_TIME_NEVER                      (UINT64_MAX)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+struct HAL_TIME_Event;
+typedef void (*HAL_TIME_Callback)(struct HAL_TIME_Event *event, uintptr_t context);
+
+typedef struct HAL_TIME_Event{
+    struct HAL_TIME_Event   *next;
+    uint64_t                deadline;
+    bool                    active;
+    HAL_TIME_Callback       callback;
+    uintptr_t               context;
+}HAL_TIME_Event;
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+void        HAL_time_initialize         (void);
+uint32_t    HAL_time_frequency_get      (void);
+uint64_t    HAL_time_now                (void);
+uint64_t    HAL_time_now_us             (void);
+uint64_t    HAL_time_now_ns             (void);
+uint64_t    HAL_time_us_to_ticks        (uint64_t us);
+uint64_t    HAL_time_ns_to_ticks        (uint64_t ns);
+uint64_t    HAL_time_next_deadline      (void);
+
+void        HAL_time_event_init         (HAL_TIME_Event *event, HAL_TIME_Callback callback, uintptr_t context);
+void        HAL_time_event_start_at     (HAL_TIME_Event *event, uint64_t deadline);
+void        HAL_time_event_start        (HAL_TIME_Event *event, uint64_t delayNs);
+void        HAL_time_event_stop         (HAL_TIME_Event *event);
+bool        HAL_time_event_is_active    (HAL_TIME_Event *event);
+
+void        HAL_time_interrupt_handler  (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //HAL_TIME_H
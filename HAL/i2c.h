@@ -0,0 +1,116 @@
+/**
+ * @file i2c.h
+ * @brief Interrupt driven I2C master. Transactions are queued per channel and run one after the other from the master
+ * interrupt, each one an optional write phase followed by an optional read phase behind a repeated start. Several
+ * devices on one bus share the queue. Transactions are owned by the caller and must stay valid until they complete.
+ * I2C_interrupt_handler must be called from the master and bus collision vectors of the channel.
+ *
+ * A transaction that does not complete within the timeout, a slave stretching the clock forever or holding SDA low,
+ * resets the module and fails with I2C_ERROR_TIMEOUT. When recovery pins are set the bus is then clocked free one edge
+ * per hal_time event, with interrupts enabled in between, before the next queued transaction starts. The timeout runs
+ * on hal_time, HAL_time_initialize must have been called for it to fire.
+ */
+
+#ifndef I2C_H
+#define I2C_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "gpio.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#define I2C_CHANNEL_1                       (0)
+#define I2C_CHANNEL_2                       (1)
+#define I2C_CHANNEL_3                       (2)
+#define I2C_CHANNEL_4                       (3)
+#define I2C_CHANNEL_5                       (4)
+
+#define I2C_SPEED_STANDARD                  (100000)
+#define I2C_SPEED_FAST                      (400000)
+#define I2C_SPEED_FAST_PLUS                 (1000000)
+
+/*Configuration Flags*/
+#define I2C_DEFAULT                         (0x0000)
+#define I2C_SMBUS_LEVELS                    (0x0001)
+
+#define I2C_DEFAULT_TIMEOUT_US              (10000)
+
+/*Transaction status, positive while the transaction is in the queue*/
+#define I2C_STATUS_DONE                     (0)
+#define I2C_STATUS_QUEUED                   (1)
+#define I2C_STATUS_ACTIVE                   (2)
+#define I2C_ERROR_NACK                      (-1)
+#define I2C_ERROR_BUS_COLLISION             (-2)
+#define I2C_ERROR_TIMEOUT                   (-3)
+#define I2C_ERROR_ABORTED                   (-4)
+/**********************************************************************
+* Preprocessor Macros
+**********************************************************************/
+#define I2C_TRANSACTION(addr, txBuffer, txSize, rxBuffer, rxSize)   {.address = (addr), .writeBuffer = (txBuffer), \
+                                                                     .writeSize = (txSize), .readBuffer = (rxBuffer), \
+                                                                     .readSize = (rxSize)}
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+struct I2C_Transaction;
+typedef void (*I2C_Callback)(struct I2C_Transaction *transaction, uintptr_t context);
+
+/*address is the 7 bit slave address. The callback runs in interrupt context once status is final*/
+typedef struct I2C_Transaction{
+    struct I2C_Transaction  *next;
+    uint8_t                 address;
+    const uint8_t           *writeBuffer;
+    size_t                  writeSize;
+    uint8_t                 *readBuffer;
+    size_t                  readSize;
+    I2C_Callback            callback;
+    uintptr_t               context;
+    volatile int            status;
+}I2C_Transaction;
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         I2C_initialize              (uint32_t i2cChannel, uint32_t configFlags, uint32_t frequency);
+void        I2C_deinitialize            (uint32_t i2cChannel);
+void        I2C_timeout_set             (uint32_t i2cChannel, uint32_t us);
+/*Pins the module drives, used as GPIO to clock a stuck slave free. I2C_bus_recover busy waits, call it from thread
+ context only*/
+void        I2C_recovery_pins_set       (uint32_t i2cChannel, GPIO_PinMap sclPin, GPIO_PinMap sdaPin);
+bool        I2C_bus_recover             (uint32_t i2cChannel);
+
+bool        I2C_submit                  (uint32_t i2cChannel, I2C_Transaction *transaction);
+/*Idles the core until the transaction completes, not to be called from interrupt context*/
+int         I2C_wait                    (I2C_Transaction *transaction);
+int         I2C_write_read              (uint32_t i2cChannel, uint8_t address, const void *txBuffer, size_t txSize,
+                                         void *rxBuffer, size_t rxSize);
+bool        I2C_is_busy                 (uint32_t i2cChannel);
+void        I2C_interrupt_handler       (uint32_t i2cChannel);
+
+static inline
+int         I2C_write                   (uint32_t i2cChannel, uint8_t address, const void *txBuffer, size_t size)
+{
+    return I2C_write_read(i2cChannel, address, txBuffer, size, NULL, 0);
+}
+
+static inline
+int         I2C_read                    (uint32_t i2cChannel, uint8_t address, void *rxBuffer, size_t size)
+{
+    return I2C_write_read(i2cChannel, address, NULL, 0, rxBuffer, size);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //I2C_H
@@ -0,0 +1,99 @@
+/**
+ * @file ic.h
+ * @brief Input Capture driver. Captured timestamps are streamed from the 4-deep IC FIFO into a buffer by the
+ * IC interrupt, or straight from ICxBUF by DMA triggered by the capture event.
+ */
+
+#ifndef IC_H
+#define IC_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "dma.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#define IC_CHANNEL_1                        (0)
+#define IC_CHANNEL_2                        (1)
+#define IC_CHANNEL_3                        (2)
+#define IC_CHANNEL_4                        (3)
+#define IC_CHANNEL_5                        (4)
+#define IC_CHANNEL_6                        (5)
+#define IC_CHANNEL_7                        (6)
+#define IC_CHANNEL_8                        (7)
+#define IC_CHANNEL_9                        (8)
+
+/*FLAGS*/
+#define IC_MODE_OFF                         (0x0000)
+#define IC_MODE_EVERY_EDGE                  (0x0001)
+#define IC_MODE_FALLING                     (0x0002)
+#define IC_MODE_RISING                      (0x0003)
+#define IC_MODE_EVERY_4TH_RISING            (0x0004)
+#define IC_MODE_EVERY_16TH_RISING           (0x0005)
+#define IC_MODE_EDGE_DETECT                 (0x0006)
+#define IC_MODE_INTERRUPT_ONLY              (0x0007)
+#define IC_MODE_USE_TMR3                    (0)
+#define IC_MODE_USE_TMR2                    (0x0008)
+#define IC_MODE_32                          (0x0020)
+#define IC_FIRST_EDGE_RISING                (0x0040)
+#define IC_INTERRUPT_EVERY_1                (0x0000)
+#define IC_INTERRUPT_EVERY_2                (0x0100)
+#define IC_INTERRUPT_EVERY_3                (0x0200)
+#define IC_INTERRUPT_EVERY_4                (0x0300)
+
+#define IC_FIFO_DEPTH                       (4)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef void (*IC_Callback)(uint32_t icChannel, uintptr_t context);
+
+typedef struct{
+    uint32_t    period;         /*Timer ticks*/
+    uint32_t    highTime;       /*Timer ticks*/
+    uint32_t    frequency;      /*Hz*/
+    uint32_t    duty;           /*Hundredths of a percent*/
+}IC_Measurement;
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+void        IC_initialize               (uint32_t icChannel, uint32_t flags);
+void        IC_deinitialize             (uint32_t icChannel);
+void        IC_enable                   (uint32_t icChannel);
+void        IC_disable                  (uint32_t icChannel);
+uint32_t    IC_timer_get                (uint32_t icChannel);
+bool        IC_data_available           (uint32_t icChannel);
+bool        IC_overflow_get             (uint32_t icChannel);
+uint32_t    IC_read                     (uint32_t icChannel);
+size_t      IC_fifo_read                (uint32_t icChannel, uint32_t *buffer, size_t size);
+
+void        IC_buffer_set               (uint32_t icChannel, uint32_t *buffer, size_t size);
+size_t      IC_buffer_count             (uint32_t icChannel);
+size_t      IC_buffer_read              (uint32_t icChannel, uint32_t *buffer, size_t size);
+void        IC_callback_register        (uint32_t icChannel, IC_Callback callback, uintptr_t context);
+void        IC_interrupt_set            (uint32_t icChannel, bool state);
+void        IC_interrupt_handler        (uint32_t icChannel);
+
+bool        IC_dma_start                (uint32_t icChannel, DMA_Channel dmaChannel, void *buffer, size_t count, bool circular);
+void        IC_dma_stop                 (uint32_t icChannel, DMA_Channel dmaChannel);
+size_t      IC_dma_index_get            (uint32_t icChannel, DMA_Channel dmaChannel);
+
+uint32_t    IC_ticks_elapsed            (uint32_t icChannel, uint32_t start, uint32_t end);
+uint32_t    IC_frequency_measure        (uint32_t icChannel, const uint32_t *timestamps, size_t count);
+bool        IC_pulse_measure            (uint32_t icChannel, const uint32_t *timestamps, size_t count, bool firstRising,
+                                         IC_Measurement *measurement);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //IC_H
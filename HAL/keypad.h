@@ -0,0 +1,68 @@
+/**
+ * @file keypad.h
+ * @brief Keypad matrix and quadrature encoder scanning service. One row of the matrix is scanned per timer tick
+ * with a single column port read and one LAT SET/CLR update of the rows, encoders are decoded on change notice.
+ * Key and encoder events are queued as one byte: type in bits 7-6, key/encoder index in bits 5-0.
+ */
+
+#ifndef KEYPAD_H
+#define KEYPAD_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "gpio.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#ifndef KEYPAD_MAX_ROWS
+#define KEYPAD_MAX_ROWS                     (8)
+#endif
+#ifndef KEYPAD_MAX_ENCODERS
+#define KEYPAD_MAX_ENCODERS                 (4)
+#endif
+#ifndef KEYPAD_EVENT_QUEUE_SIZE
+#define KEYPAD_EVENT_QUEUE_SIZE             (32)
+#endif
+#define KEYPAD_MAX_KEYS                     (64)
+
+#define KEYPAD_EVENT_KEY_RELEASE            (0x00)
+#define KEYPAD_EVENT_KEY_PRESS              (0x40)
+#define KEYPAD_EVENT_ENCODER_CW             (0x80)
+#define KEYPAD_EVENT_ENCODER_CCW            (0xC0)
+#define KEYPAD_EVENT_TYPE_MASK              (0xC0)
+#define KEYPAD_EVENT_INDEX_MASK             (0x3F)
+/**********************************************************************
+* Preprocessor Macros
+**********************************************************************/
+#define KEYPAD_EVENT_TYPE(event)            ((event) & KEYPAD_EVENT_TYPE_MASK)
+#define KEYPAD_EVENT_INDEX(event)           ((event) & KEYPAD_EVENT_INDEX_MASK)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         KEYPAD_initialize           (uint32_t tmrChannel, uint32_t scanFrequency);
+int         KEYPAD_matrix_set           (GPIO_Port rowPort, uint32_t rowMask, GPIO_Port colPort, uint32_t colMask);
+int         KEYPAD_encoder_register     (GPIO_PinMap pinA, GPIO_PinMap pinB, uint32_t stepsPerDetent);
+void        KEYPAD_start                (void);
+void        KEYPAD_stop                 (void);
+
+bool        KEYPAD_event_get            (uint8_t *event);
+bool        KEYPAD_key_state_get        (uint32_t key);
+int32_t     KEYPAD_encoder_position_get (uint32_t encoder);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //KEYPAD_H
@@ -0,0 +1,75 @@
+/**
+ * @file logic_analyzer.h
+ * @brief Timer triggered DMA capture of a GPIO port. Samples are stored into a circular pre-trigger buffer until
+ * a change notice on the trigger pins (or LA_trigger) switches the capture to the linear post-trigger buffer.
+ * On the PIC32MZ the sample buffers must be placed in coherent (uncached) memory.
+ */
+
+#ifndef LOGIC_ANALYZER_H
+#define LOGIC_ANALYZER_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "gpio.h"
+#include "dma.h"
+#include "uart.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#define LA_NO_TRIGGER                       (0)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef enum{
+    LA_STATE_IDLE,
+    LA_STATE_ARMED,
+    LA_STATE_TRIGGERED,
+    LA_STATE_DONE,
+}LA_STATE;
+
+typedef struct{
+    GPIO_Port       port;
+    uint16_t        mask;
+    uint32_t        tmrChannel;
+    uint32_t        frequency;
+    DMA_Channel     preDmaChannel;
+    DMA_Channel     postDmaChannel;
+    uint16_t        *preBuffer;
+    size_t          preCount;
+    uint16_t        *postBuffer;
+    size_t          postCount;
+}LA_Config;
+
+typedef void (*LA_Callback)(uintptr_t context);
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         LA_initialize               (const LA_Config *config);
+bool        LA_start                    (GPIO_PinMap triggerPins);
+void        LA_trigger                  (void);
+void        LA_stop                     (void);
+LA_STATE    LA_state_get                (void);
+void        LA_callback_register        (LA_Callback callback, uintptr_t context);
+
+size_t      LA_sample_count             (void);
+size_t      LA_trigger_index_get        (void);
+uint16_t    LA_sample_get               (size_t index);
+
+size_t      LA_rle_encode               (uint8_t *buffer, size_t size);
+size_t      LA_export                   (UART_Channel channel);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //LOGIC_ANALYZER_H
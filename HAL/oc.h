@@ -9,6 +9,7 @@
 * Includes
 **********************************************************************/
 #include "hal_defs.h"
+#include "dma.h"
 /**********************************************************************
 * Preprocessor Constants
 **********************************************************************/
@@ -22,17 +23,37 @@
 #define OC_CHANNEL_8                        (7)
 #define OC_CHANNEL_9                        (8)
 
-#define OC_MDOE_PWM_FAULT_ENABLED           (0x0007)
+/*Modes, OCM bits*/
+#define OC_MODE_DISABLED                    (0x0000)
+#define OC_MODE_SET_HIGH                    (0x0001)
+#define OC_MODE_SET_LOW                     (0x0002)
+#define OC_MODE_TOGGLE                      (0x0003)
+#define OC_MODE_SINGLE_PULSE                (0x0004)
+#define OC_MODE_CONTINUOUS_PULSE            (0x0005)
 #define OC_MODE_PWM                         (0x0006)
+/*PWM with the OCFA input as fault, the output is driven to its inactive state while the fault is present*/
+#define OC_MODE_PWM_FAULT_ENABLED           (0x0007)
+#define OC_MDOE_PWM_FAULT_ENABLED           (OC_MODE_PWM_FAULT_ENABLED)
 #define OC_MODE_32                          (0x0020)
 #define OC_MODE_USE_TMR3                    (0x0008)
 #define OC_MODE_USE_TMR2                    (0)
 
+/*DMA flags*/
+#define OC_DMA_REPEAT                       (0x0001)
+
+/*DMA events, with OC_DMA_REPEAT each event tells which half of the table can be refilled*/
+#define OC_DMA_EVENT_FIRST_HALF             (0)
+#define OC_DMA_EVENT_SECOND_HALF            (1)
+#define OC_DMA_EVENT_ERROR                  (2)
+
 /**********************************************************************
 * Typedefs
 **********************************************************************/
 #if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
 
+typedef void (*OC_Callback)(uint32_t ocChannel, uintptr_t context);
+typedef void (*OC_DMA_Callback)(uint32_t ocChannel, uint32_t event, uintptr_t context);
+
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
@@ -41,10 +62,28 @@ extern "C"{
 #endif
 
 void        OC_initialize   (uint32_t ocChannel, uint32_t flags, uint32_t compareValue);
+void        OC_deinitialize (uint32_t ocChannel);
 void        OC_enable       (uint32_t ocChannel);
 void        OC_disable      (uint32_t ocChannel);
 void        OC_compare_set  (uint32_t ocChannel, uint32_t compareValue);
 uint32_t    OC_compare_get  (uint32_t ocChannel);
+uint32_t    OC_timer_get    (uint32_t ocChannel);
+void        OC_mode_set     (uint32_t ocChannel, uint32_t mode);
+void        OC_compare_dual_set     (uint32_t ocChannel, uint32_t riseValue, uint32_t fallValue);
+bool        OC_pulse_start          (uint32_t ocChannel, uint32_t delayTicks, uint32_t widthTicks);
+bool        OC_fault_get            (uint32_t ocChannel);
+void        OC_fault_clear          (uint32_t ocChannel);
+
+void        OC_callback_register    (uint32_t ocChannel, OC_Callback callback, uintptr_t context);
+void        OC_interrupt_set        (uint32_t ocChannel, bool state);
+void        OC_interrupt_handler    (uint32_t ocChannel);
+
+/*On the PIC32MZ tables must be placed in coherent (uncached) memory, refills included*/
+bool        OC_dma_start            (uint32_t ocChannel, DMA_Channel dmaChannel, const void *table, size_t count, uint32_t flags);
+bool        OC_dma_dual_start       (uint32_t ocChannel, DMA_Channel rDmaChannel, DMA_Channel rsDmaChannel,
+                                     const void *rTable, const void *rsTable, size_t count, uint32_t flags);
+void        OC_dma_stop             (uint32_t ocChannel);
+void        OC_dma_callback_register(uint32_t ocChannel, OC_DMA_Callback callback, uintptr_t context);
 #ifdef __cplusplus
 }
 #endif
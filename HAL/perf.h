@@ -0,0 +1,108 @@
+/**
+ * @file perf.h
+ * @brief Code region profiling on the CP0 counters. Cycles come from the core timer on both parts, the PIC32MZ
+ * microAptiv core adds two performance counters, by default instructions and D-cache misses. The PIC32MX M4K core has
+ * none, there regions are measured in cycles only and event counts stay at zero.
+ *
+ * A region is a static object, the measured block is written as
+ *      static SYS_PERF_REGION(spiTransfer);
+ *      SYS_PERF_MEASURE(spiTransfer){
+ *          SPI_transfer(SPI_CHANNEL_2, tx, rx, sizeof(tx));
+ *      }
+ * Leaving the block with break, return or goto skips the measurement.
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#define SYS_PERF_COUNTERS                   (2)
+#define SYS_PERF_COUNTER_0                  (0)
+#define SYS_PERF_COUNTER_1                  (1)
+
+/*microAptiv event numbers, the prefix is the counter the event is available on*/
+#define SYS_PERF_CYCLES                     (0)
+#define SYS_PERF_INSTRUCTIONS               (1)
+#define SYS_PERF_C0_ICACHE_ACCESSES         (9)
+#define SYS_PERF_C1_ICACHE_MISSES           (9)
+#define SYS_PERF_C0_DCACHE_ACCESSES         (11)
+#define SYS_PERF_C1_DCACHE_MISSES           (11)
+#define SYS_PERF_C0_STALLS                  (18)
+#define SYS_PERF_NONE                       (0xFF)
+/**********************************************************************
+* Preprocessor Macros
+**********************************************************************/
+#define SYS_PERF_REGION(region)             SYS_Perf_Region region = {.name = #region}
+#define SYS_PERF_MEASURE(region)            for(SYS_Perf_Sample _perfSample = SYS_perf_begin(&(region)); \
+                                                _perfSample.running; SYS_perf_end(&(region), &_perfSample))
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef struct{
+    uint32_t    cycles;
+    uint32_t    events[SYS_PERF_COUNTERS];
+    bool        running;
+}SYS_Perf_Sample;
+
+typedef struct SYS_Perf_Region{
+    const char              *name;
+    uint32_t                calls;
+    uint64_t                cycles;
+    uint32_t                minCycles;
+    uint32_t                maxCycles;
+    uint64_t                events[SYS_PERF_COUNTERS];
+    bool                    linked;
+    struct SYS_Perf_Region  *next;
+}SYS_Perf_Region;
+
+/*Averages per call, IPC is in instructions per 1000 cycles and only set while counter 0 counts instructions*/
+typedef struct{
+    const char  *name;
+    uint32_t    calls;
+    uint32_t    cycles;
+    uint32_t    minCycles;
+    uint32_t    maxCycles;
+    uint32_t    ipcMilli;
+    uint32_t    events[SYS_PERF_COUNTERS];
+}SYS_Perf_Result;
+
+typedef void (*SYS_Perf_Report_Callback)(const SYS_Perf_Result *result, uintptr_t context);
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/*Counts instructions and D-cache misses where available and calibrates the measurement overhead out*/
+void            SYS_perf_initialize     (void);
+bool            SYS_perf_available      (void);
+int             SYS_perf_counter_set    (uint32_t counter, uint32_t event);
+uint32_t        SYS_perf_counter_get    (uint32_t counter);
+uint32_t        SYS_perf_cycles_get     (void);
+uint32_t        SYS_perf_counter_event_get(uint32_t counter);
+/*Family layer, reads the cycle and event counters at one point in time*/
+void            SYS_perf_sample         (SYS_Perf_Sample *sample);
+
+SYS_Perf_Sample SYS_perf_begin          (SYS_Perf_Region *region);
+void            SYS_perf_end            (SYS_Perf_Region *region, SYS_Perf_Sample *sample);
+void            SYS_perf_result_get     (const SYS_Perf_Region *region, SYS_Perf_Result *result);
+/*Calls back once per region measured since the last reset, in order of first use*/
+void            SYS_perf_report         (SYS_Perf_Report_Callback callback, uintptr_t context);
+void            SYS_perf_reset          (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //PERF_H
@@ -4,6 +4,7 @@
 * Includes
 **********************************************************************/
 #include "hal_defs.h"
+#include "gpio.h"
 /**********************************************************************
 * Preprocessor Constants
 **********************************************************************/
@@ -52,8 +53,8 @@
 #define PPS_INPUT_REG_IC1               (volatile uint32_t*)(&IC1R)
 #define PPS_INPUT_REG_IC6               (volatile uint32_t*)(&IC6R)
 #define PPS_INPUT_REG_U3CTS             (volatile uint32_t*)(&U3CTSR)
-#define PPS_INPUT_REG_U4RX              (volatile uint32_t*)(&U4R)
-#define PPS_INPUT_REG_U6RX              (volatile uint32_t*)(&U6R)
+#define PPS_INPUT_REG_U4RX              (volatile uint32_t*)(&U4RXR)
+#define PPS_INPUT_REG_U6RX              (volatile uint32_t*)(&U6RXR)
 #define PPS_INPUT_REG_SS2               (volatile uint32_t*)(&SS2R)
 #define PPS_INPUT_REG_SDI6              (volatile uint32_t*)(&SDI6R)
 #define PPS_INPUT_REG_OCFA              (volatile uint32_t*)(&OCFAR)
@@ -90,7 +91,7 @@
 #define PPS_OUTPUT_REG_RPD9             (volatile uint32_t*)(&RPD9R)
 #define PPS_OUTPUT_REG_RPG6             (volatile uint32_t*)(&RPG6R)
 #define PPS_OUTPUT_REG_RPB8             (volatile uint32_t*)(&RPB8R)
-#define PPS_OUTPUT_REG_RPb15            (volatile uint32_t*)(&RPb15R)
+#define PPS_OUTPUT_REG_RPB15            (volatile uint32_t*)(&RPB15R)
 #define PPS_OUTPUT_REG_RPD4             (volatile uint32_t*)(&RPD4R)
 #define PPS_OUTPUT_REG_RPB0             (volatile uint32_t*)(&RPB0R)
 #define PPS_OUTPUT_REG_RPE3             (volatile uint32_t*)(&RPE3R)
@@ -113,6 +114,144 @@
 #define PPS_OUTPUT_REG_RPE8             (volatile uint32_t*)(&RPE8R)
 #define PPS_OUTPUT_REG_RPF2             (volatile uint32_t*)(&RPF2R)
 
+/*Function identifiers for PPS_map, inputs carry their group and register index, outputs the RPnR code of each
+group they can be routed to (0 where they cannot)*/
+#define PPS_OUTPUT_FLAG                 (0x10000)
+#define PPS_GROUPS                      (4)
+#define PPS_NUMBER_OF_PORTS             (GPIO_PORT_G + 1)
+#define PPS_NUMBER_OF_INPUTS            (51)
+
+#define PPS_IN_INT3                     (0x100)
+#define PPS_IN_T2CK                     (0x101)
+#define PPS_IN_T6CK                     (0x102)
+#define PPS_IN_IC3                      (0x103)
+#define PPS_IN_IC7                      (0x104)
+#define PPS_IN_U1RX                     (0x105)
+#define PPS_IN_U2CTS                    (0x106)
+#define PPS_IN_U5RX                     (0x107)
+#define PPS_IN_U6CTS                    (0x108)
+#define PPS_IN_SDI1                     (0x109)
+#define PPS_IN_SDI3                     (0x10A)
+#define PPS_IN_SDI5                     (0x10B)
+#define PPS_IN_SS6                      (0x10C)
+#define PPS_IN_REFCLKI1                 (0x10D)
+#define PPS_IN_INT4                     (0x20E)
+#define PPS_IN_T5CK                     (0x20F)
+#define PPS_IN_T7CK                     (0x210)
+#define PPS_IN_IC4                      (0x211)
+#define PPS_IN_IC8                      (0x212)
+#define PPS_IN_U3RX                     (0x213)
+#define PPS_IN_U4CTS                    (0x214)
+#define PPS_IN_SDI2                     (0x215)
+#define PPS_IN_SDI4                     (0x216)
+#define PPS_IN_C1RX                     (0x217)
+#define PPS_IN_REFCLKI4                 (0x218)
+#define PPS_IN_INT2                     (0x319)
+#define PPS_IN_T3CK                     (0x31A)
+#define PPS_IN_T8CK                     (0x31B)
+#define PPS_IN_IC2                      (0x31C)
+#define PPS_IN_IC5                      (0x31D)
+#define PPS_IN_IC9                      (0x31E)
+#define PPS_IN_U1CTS                    (0x31F)
+#define PPS_IN_U2RX                     (0x320)
+#define PPS_IN_U5CTS                    (0x321)
+#define PPS_IN_SS1                      (0x322)
+#define PPS_IN_SS3                      (0x323)
+#define PPS_IN_SS4                      (0x324)
+#define PPS_IN_SS5                      (0x325)
+#define PPS_IN_C2RX                     (0x326)
+#define PPS_IN_INT1                     (0x427)
+#define PPS_IN_T4CK                     (0x428)
+#define PPS_IN_T9CK                     (0x429)
+#define PPS_IN_IC1                      (0x42A)
+#define PPS_IN_IC6                      (0x42B)
+#define PPS_IN_U3CTS                    (0x42C)
+#define PPS_IN_U4RX                     (0x42D)
+#define PPS_IN_U6RX                     (0x42E)
+#define PPS_IN_SS2                      (0x42F)
+#define PPS_IN_SDI6                     (0x430)
+#define PPS_IN_OCFA                     (0x431)
+#define PPS_IN_REFCLKI3                 (0x432)
+
+#define PPS_OUT_C1OUT                   (PPS_OUTPUT_FLAG | 0x0E00)
+#define PPS_OUT_C1TX                    (PPS_OUTPUT_FLAG | 0x000F)
+#define PPS_OUT_C2OUT                   (PPS_OUTPUT_FLAG | 0x000E)
+#define PPS_OUT_C2TX                    (PPS_OUTPUT_FLAG | 0xF000)
+#define PPS_OUT_OC1                     (PPS_OUTPUT_FLAG | 0xC000)
+#define PPS_OUT_OC2                     (PPS_OUTPUT_FLAG | 0xB000)
+#define PPS_OUT_OC3                     (PPS_OUTPUT_FLAG | 0x000B)
+#define PPS_OUT_OC4                     (PPS_OUTPUT_FLAG | 0x00B0)
+#define PPS_OUT_OC5                     (PPS_OUTPUT_FLAG | 0x0B00)
+#define PPS_OUT_OC6                     (PPS_OUTPUT_FLAG | 0x000C)
+#define PPS_OUT_OC7                     (PPS_OUTPUT_FLAG | 0x00C0)
+#define PPS_OUT_OC8                     (PPS_OUTPUT_FLAG | 0x0C00)
+#define PPS_OUT_OC9                     (PPS_OUTPUT_FLAG | 0xD000)
+#define PPS_OUT_REFCLKO1                (PPS_OUTPUT_FLAG | 0x00F0)
+#define PPS_OUT_REFCLKO3                (PPS_OUTPUT_FLAG | 0x0F00)
+#define PPS_OUT_REFCLKO4                (PPS_OUTPUT_FLAG | 0x000D)
+#define PPS_OUT_SDO1                    (PPS_OUTPUT_FLAG | 0x0055)
+#define PPS_OUT_SDO2                    (PPS_OUTPUT_FLAG | 0x0066)
+#define PPS_OUT_SDO3                    (PPS_OUTPUT_FLAG | 0x0077)
+#define PPS_OUT_SDO4                    (PPS_OUTPUT_FLAG | 0x8080)
+#define PPS_OUT_SDO5                    (PPS_OUTPUT_FLAG | 0x0099)
+#define PPS_OUT_SDO6                    (PPS_OUTPUT_FLAG | 0xAA00)
+#define PPS_OUT_SS1                     (PPS_OUTPUT_FLAG | 0x0500)
+#define PPS_OUT_SS2                     (PPS_OUTPUT_FLAG | 0x6000)
+#define PPS_OUT_SS3                     (PPS_OUTPUT_FLAG | 0x0700)
+#define PPS_OUT_SS4                     (PPS_OUTPUT_FLAG | 0x0800)
+#define PPS_OUT_SS5                     (PPS_OUTPUT_FLAG | 0x0900)
+#define PPS_OUT_SS6                     (PPS_OUTPUT_FLAG | 0x000A)
+#define PPS_OUT_U1RTS                   (PPS_OUTPUT_FLAG | 0x1000)
+#define PPS_OUT_U1TX                    (PPS_OUTPUT_FLAG | 0x0010)
+#define PPS_OUT_U2RTS                   (PPS_OUTPUT_FLAG | 0x0020)
+#define PPS_OUT_U2TX                    (PPS_OUTPUT_FLAG | 0x2000)
+#define PPS_OUT_U3RTS                   (PPS_OUTPUT_FLAG | 0x0100)
+#define PPS_OUT_U3TX                    (PPS_OUTPUT_FLAG | 0x0001)
+#define PPS_OUT_U4RTS                   (PPS_OUTPUT_FLAG | 0x0002)
+#define PPS_OUT_U4TX                    (PPS_OUTPUT_FLAG | 0x0200)
+#define PPS_OUT_U5RTS                   (PPS_OUTPUT_FLAG | 0x3000)
+#define PPS_OUT_U5TX                    (PPS_OUTPUT_FLAG | 0x0030)
+#define PPS_OUT_U6RTS                   (PPS_OUTPUT_FLAG | 0x0040)
+#define PPS_OUT_U6TX                    (PPS_OUTPUT_FLAG | 0x4400)
+
+/*RPn pins of each group per port*/
+#define PPS_GROUP_1_MASK(port)          ((port) == GPIO_PORT_A ? 0x4000 : (port) == GPIO_PORT_B ? 0x0620 : \
+                                         (port) == GPIO_PORT_C ? 0x4002 : (port) == GPIO_PORT_D ? 0x4444 : \
+                                         (port) == GPIO_PORT_F ? 0x0012 : (port) == GPIO_PORT_G ? 0x0102 : 0)
+#define PPS_GROUP_2_MASK(port)          ((port) == GPIO_PORT_A ? 0x8000 : (port) == GPIO_PORT_B ? 0x000A : \
+                                         (port) == GPIO_PORT_C ? 0x2010 : (port) == GPIO_PORT_D ? 0x8888 : \
+                                         (port) == GPIO_PORT_E ? 0x0020 : (port) == GPIO_PORT_F ? 0x0021 : \
+                                         (port) == GPIO_PORT_G ? 0x0081 : 0)
+#define PPS_GROUP_3_MASK(port)          ((port) == GPIO_PORT_B ? 0x8181 : (port) == GPIO_PORT_C ? 0x0008 : \
+                                         (port) == GPIO_PORT_D ? 0x1210 : (port) == GPIO_PORT_E ? 0x0208 : \
+                                         (port) == GPIO_PORT_F ? 0x1100 : (port) == GPIO_PORT_G ? 0x0040 : 0)
+#define PPS_GROUP_4_MASK(port)          ((port) == GPIO_PORT_B ? 0x4044 : (port) == GPIO_PORT_C ? 0x0004 : \
+                                         (port) == GPIO_PORT_D ? 0x0023 : (port) == GPIO_PORT_E ? 0x0100 : \
+                                         (port) == GPIO_PORT_F ? 0x200C : (port) == GPIO_PORT_G ? 0x0200 : 0)
+
+/**********************************************************************
+* Preprocessor Macros
+**********************************************************************/
+#define PPS_IS_OUTPUT(function)         (((function) & PPS_OUTPUT_FLAG) != 0)
+#define PPS_INPUT_GROUP(function)       (((function) >> 8) & 0xF)
+#define PPS_INPUT_INDEX(function)       ((function) & 0xFF)
+#define PPS_OUTPUT_CODE(function, group) (((function) >> (4 * ((group) - 1))) & 0xF)
+
+#define PPS_PIN_PORT(pin)               (((pin) & GPIO_PORT_MASK) >> GPIO_PORT_SHIFT)
+#define PPS_PIN_SINGLE(pin)             (((pin) & GPIO_PIN_MASK) != 0 && ((pin) & ((pin) - 1) & GPIO_PIN_MASK) == 0)
+#define PPS_PIN_GROUP(pin)              ((PPS_GROUP_1_MASK(PPS_PIN_PORT(pin)) & (pin)) ? 1 : \
+                                         (PPS_GROUP_2_MASK(PPS_PIN_PORT(pin)) & (pin)) ? 2 : \
+                                         (PPS_GROUP_3_MASK(PPS_PIN_PORT(pin)) & (pin)) ? 3 : \
+                                         (PPS_GROUP_4_MASK(PPS_PIN_PORT(pin)) & (pin)) ? 4 : 0)
+/*True when function can be routed to the GPIO_PIN_MAP pin, a constant expression for constant arguments*/
+#define PPS_VALID(function, pin)        (PPS_PIN_SINGLE(pin) && PPS_PIN_GROUP(pin) != 0 && \
+                                         (PPS_IS_OUTPUT(function) ? PPS_OUTPUT_CODE(function, PPS_PIN_GROUP(pin)) != 0 \
+                                                                  : PPS_INPUT_GROUP(function) == PPS_PIN_GROUP(pin)))
+/*PPS_map with the routing checked at build time*/
+#define PPS_MAP_STATIC(function, pin)   do{ _Static_assert(PPS_VALID(function, pin), \
+                                            #function " cannot be routed to " #pin); \
+                                            PPS_map(function, pin); }while(0)
+
 /**********************************************************************
 * Typedefs
 **********************************************************************/
@@ -714,6 +853,21 @@ enum PPS_SS5{
     PPS_SS5_RPC3 	 = 12,
     PPS_SS5_RPE9 	 = 13,
 };
+enum PPS_C2RX{
+    PPS_C2RX_RPD9 	 = 0,
+    PPS_C2RX_RPG6 	 = 1,
+    PPS_C2RX_RPB8 	 = 2,
+    PPS_C2RX_RPB15 	 = 3,
+    PPS_C2RX_RPD4 	 = 4,
+    PPS_C2RX_RPB0 	 = 5,
+    PPS_C2RX_RPE3 	 = 6,
+    PPS_C2RX_RPB7 	 = 7,
+    PPS_C2RX_RPF12 	 = 9,
+    PPS_C2RX_RPD12 	 = 10,
+    PPS_C2RX_RPF8 	 = 11,
+    PPS_C2RX_RPC3 	 = 12,
+    PPS_C2RX_RPE9 	 = 13,
+};
 enum PPS_INT1{
     PPS_INT1_RPD1 	 = 0,
     PPS_INT1_RPG9 	 = 1,
@@ -1688,6 +1842,8 @@ extern "C"{
 #endif
 
 void PPS_pin_mapping(PPS_Register reg, PPS_AlternateFunction af);
+/*Routes function (PPS_IN_x or PPS_OUT_x) to pin, -1 when the pin is not in one of its groups. IOLOCK must be clear*/
+int  PPS_map(uint32_t function, GPIO_PinMap pin);
 
 #ifdef __cplusplus
 }
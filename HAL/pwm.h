@@ -0,0 +1,60 @@
+/**
+ * @file pwm.h
+ * @brief Synchronised PWM over several OC channels sharing TMR2 or TMR3. Duty cycles are staged per channel and
+ * committed together from the timer interrupt right after a period match, so every channel changes on the same period.
+ */
+
+#ifndef PWM_H
+#define PWM_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#define PWM_GROUP_MAX_CHANNELS              (9)
+/*Duty cycles in percent are given in hundredths of a percent*/
+#define PWM_DUTY_PERCENT_MAX                (10000)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef struct{
+    uint32_t            tmrChannel;
+    uint32_t            channels[PWM_GROUP_MAX_CHANNELS];
+    uint32_t            count;
+    uint32_t            staged[PWM_GROUP_MAX_CHANNELS];
+    uint32_t            committed[PWM_GROUP_MAX_CHANNELS];
+    volatile bool       pending;
+}PWM_Group;
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         PWM_group_initialize        (PWM_Group *group, uint32_t tmrChannel, const uint32_t *ocChannels, size_t count,
+                                         uint32_t frequency);
+void        PWM_group_start             (PWM_Group *group);
+void        PWM_group_stop              (PWM_Group *group);
+
+void        PWM_duty_ticks_set          (PWM_Group *group, uint32_t index, uint32_t ticks);
+void        PWM_duty_percent_set        (PWM_Group *group, uint32_t index, uint32_t duty);
+void        PWM_duty_ns_set             (PWM_Group *group, uint32_t index, uint32_t ns);
+void        PWM_group_commit            (PWM_Group *group);
+bool        PWM_group_commit_pending    (PWM_Group *group);
+
+uint32_t    PWM_resolution_get          (PWM_Group *group);
+uint32_t    PWM_tick_ns_get             (PWM_Group *group);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //PWM_H
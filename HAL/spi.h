@@ -94,6 +94,7 @@ extern "C"{
 #endif
 
 int         SPI_initialize              (uint32_t spiChannel, uint32_t configFlags, uint32_t baudrate);
+void        SPI_deinitialize            (uint32_t spiChannel);
 size_t      SPI_transfer                (uint32_t spiChannel, void *txBuffer, void *rxBuffer, size_t size);
 uint8_t     SPI_byte_transfer           (uint32_t spiChannel, uint8_t data);
 bool        SPI_is_busy                 (uint32_t spiChannel);
@@ -101,6 +102,7 @@ void        SPI_callback_register       (SPI_Channel spiChannel, SPI_Callback ca
 bool        SPI_transfer_isr            (uint32_t spiChannel, void* txBuffer, void* rxBuffer, size_t size);
 void        SPI_rx_interrupt_handler    (SPI_Channel spiChannel);
 void        SPI_tx_interrupt_handler    (SPI_Channel spiChannel);
+void        SPI_interrupt_handler       (SPI_Channel spiChannel);
 bool        SPI_write_dma               (SPI_Channel spiChannel, uint32_t dmaChannel, void *txBuffer, size_t size);
 bool        SPI_read_dma                (SPI_Channel spiChannel, uint32_t dmaChannel, void *rxBuffer, size_t size);
 void        SPI_setup                   (SPI_Channel spiChannel, uint32_t configFlags, uint32_t baudrate);
@@ -0,0 +1,66 @@
+/**
+ * @file stepper.h
+ * @brief Stepper motion engine. Acceleration ramps are precomputed in fixed point into tables of step periods
+ * (timer ticks), each axis then runs from its own timer interrupt which only toggles the step pin and reloads PR.
+ */
+
+#ifndef STEPPER_H
+#define STEPPER_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "gpio.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#ifndef STEPPER_MAX_AXES
+#define STEPPER_MAX_AXES                    (4)
+#endif
+
+#define STEPPER_AXIS_0                      (0)
+#define STEPPER_AXIS_1                      (1)
+#define STEPPER_AXIS_2                      (2)
+#define STEPPER_AXIS_3                      (3)
+/**********************************************************************
+* Preprocessor Macros
+**********************************************************************/
+#define STEPPER_AXIS_MASK(axis)             (1u << (axis))
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef void (*STEPPER_Callback)(uint32_t axis, uintptr_t context);
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         STEPPER_axis_initialize     (uint32_t axis, uint32_t tmrChannel, uint32_t tmrFlags, GPIO_PinMap stepPin,
+                                         GPIO_PinMap dirPin);
+uint32_t    STEPPER_tick_frequency_get  (uint32_t axis);
+size_t      STEPPER_ramp_trapezoid      (uint32_t axis, uint32_t *table, size_t size, uint32_t maxSpeed,
+                                         uint32_t acceleration);
+size_t      STEPPER_ramp_scurve         (uint32_t axis, uint32_t *table, size_t size, uint32_t maxSpeed, uint32_t rampMs);
+void        STEPPER_ramp_set            (uint32_t axis, const uint32_t *table, size_t length);
+
+bool        STEPPER_move                (uint32_t axis, int32_t steps);
+void        STEPPER_start               (uint32_t axisMask);
+void        STEPPER_halt                (uint32_t axisMask);
+void        STEPPER_stop                (uint32_t axisMask);
+bool        STEPPER_is_busy             (uint32_t axisMask);
+int32_t     STEPPER_position_get        (uint32_t axis);
+void        STEPPER_position_set        (uint32_t axis, int32_t position);
+void        STEPPER_callback_register   (uint32_t axis, STEPPER_Callback callback, uintptr_t context);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //STEPPER_H
@@ -0,0 +1,72 @@
+/**
+ * @file sw_timer.h
+ * @brief Software timers multiplexed on a single hardware timer through a hashed timer wheel.
+ * Start, stop and expiry are O(1) regardless of the number of running timers. Timers are allocated by the
+ * caller and may run their callback from the timer ISR or deferred to SWT_task.
+ */
+
+#ifndef SW_TIMER_H
+#define SW_TIMER_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+/*Number of wheel slots, must be a power of two*/
+#ifndef SWT_WHEEL_SIZE
+#define SWT_WHEEL_SIZE                      (256)
+#endif
+
+#define SWT_ONE_SHOT                        (0x0000)
+#define SWT_PERIODIC                        (0x0001)
+#define SWT_DEFERRED                        (0x0002)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+struct SWT_Timer;
+typedef void (*SWT_Callback)(struct SWT_Timer *timer, uintptr_t context);
+
+typedef struct SWT_Timer{
+    struct SWT_Timer    *next;
+    struct SWT_Timer    *prev;
+    struct SWT_Timer    *deferredNext;
+    uint32_t            slot;
+    uint32_t            rounds;
+    uint32_t            period;
+    uint32_t            flags;
+    bool                active;
+    bool                pending;
+    bool                queued;
+    SWT_Callback        callback;
+    uintptr_t           context;
+}SWT_Timer;
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         SWT_initialize              (uint32_t tmrChannel, uint32_t tickUs);
+uint32_t    SWT_ticks_get               (void);
+uint32_t    SWT_ms_to_ticks             (uint32_t ms);
+
+void        SWT_timer_init              (SWT_Timer *timer, SWT_Callback callback, uintptr_t context, uint32_t flags);
+void        SWT_timer_start             (SWT_Timer *timer, uint32_t ticks);
+void        SWT_timer_stop              (SWT_Timer *timer);
+bool        SWT_timer_is_active         (SWT_Timer *timer);
+
+void        SWT_task                    (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //SW_TIMER_H
@@ -23,12 +23,40 @@
 #define SYS_PERIPHERAL_CLOCK_7              (6)
 #define SYS_PERIPHERAL_CLOCK_8              (7)
 
+/*Peripheral module disable bits, register number and bit position. Channel numbers are the drivers' own*/
+#define SYS_PMD_MODULE(reg, bit)            (((reg) << 5) | (bit))
+#define SYS_PMD_ADC                         SYS_PMD_MODULE(1, 0)
+#define SYS_PMD_IC(channel)                 SYS_PMD_MODULE(3, (channel))
+#define SYS_PMD_OC(channel)                 SYS_PMD_MODULE(3, 16 + (channel))
+#define SYS_PMD_TMR(channel)                SYS_PMD_MODULE(4, 1 + (channel))
+#define SYS_PMD_UART(channel)               SYS_PMD_MODULE(5, (channel))
+#define SYS_PMD_SPI(channel)                SYS_PMD_MODULE(5, 8 + (channel))
+#define SYS_PMD_I2C(channel)                SYS_PMD_MODULE(5, 16 + (channel))
+#define SYS_PMD_DMA                         SYS_PMD_MODULE(7, 4)
+#define SYS_PMD_NUMBER_OF_MODULES           SYS_PMD_MODULE(8, 0)
+
+/*Power modes, also the index into SYS_Power_Stats*/
+#define SYS_POWER_RUN                       (0)
+#define SYS_POWER_IDLE                      (1)
+#define SYS_POWER_SLEEP                     (2)
+#define SYS_POWER_MODES                     (3)
+
+#ifndef SYS_CLOCK_MAX_NOTIFIERS
+#define SYS_CLOCK_MAX_NOTIFIERS             (8)
+#endif
 
 /**********************************************************************
 * Typedefs
 **********************************************************************/
 #if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
 
+/*Called with interrupts disabled right after the system clock switched, peripheral clocks follow SYSCLK*/
+typedef void (*SYS_Clock_Notifier)(uint32_t oldFrequency, uint32_t newFrequency, uintptr_t context);
+
+typedef struct{
+    uint64_t    timeNs[SYS_POWER_MODES];
+    uint32_t    entries[SYS_POWER_MODES];
+}SYS_Power_Stats;
 
 /**********************************************************************
 * Function Prototypes
@@ -45,6 +73,31 @@ void        SYS_peripheral_clock_config(uint32_t clockChannel, uint32_t flags);
 uint32_t    SYS_peripheral_clock_frequency_get(uint32_t clockChannel);
 void        SYS_soft_reset(uint32_t rconVal);
 
+uint32_t    SYS_clock_frequency_get(void);
+uint32_t    SYS_clock_set(uint32_t frequency);
+void        SYS_flash_wait_states_update(void);
+
+/*Reference counted module power. Modules with a HAL driver start gated from SYS_initialize, the first acquire powers
+ the module (and its PBCLK bus), the last release gates it. Parts without PMD registers only keep the counts.*/
+void        SYS_pmd_acquire(uint32_t module);
+void        SYS_pmd_release(uint32_t module);
+uint32_t    SYS_pmd_count_get(uint32_t module);
+
+/*Both return the mode actually entered once the core is awake again. Sleep falls back to Idle while it is inhibited or
+ a DMA channel is enabled. Call them with interrupts disabled after checking for pending work, wait still returns on
+ an interrupt request and the handler runs once the caller restores interrupts. The timer driver is no wake source,
+ TMR2-TMR9 stop in Sleep.*/
+uint32_t    SYS_idle(void);
+uint32_t    SYS_sleep(void);
+void        SYS_power_inhibit(uint32_t mode);
+void        SYS_power_allow(uint32_t mode);
+void        SYS_power_stats_get(SYS_Power_Stats *stats);
+void        SYS_power_stats_reset(void);
+/*Time source for the statistics, the core timer stops in Sleep so boards with an RTCC or TMR1 on SOSC override it*/
+uint64_t    SYS_power_timestamp_get(void);
+bool        SYS_clock_notifier_register(SYS_Clock_Notifier notifier, uintptr_t context);
+void        SYS_clock_notifier_unregister(SYS_Clock_Notifier notifier, uintptr_t context);
+
 #ifdef __cplusplus
 }
 #endif //__cplusplus
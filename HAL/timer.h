@@ -17,6 +17,12 @@
 #define TMR_CHANNEL_8                   (6)
 #define TMR_CHANNEL_9                   (7)
 
+/*32 bit pairs, addressed through the even timer*/
+#define TMR_CHANNEL_23                  (TMR_CHANNEL_2)
+#define TMR_CHANNEL_45                  (TMR_CHANNEL_4)
+#define TMR_CHANNEL_67                  (TMR_CHANNEL_6)
+#define TMR_CHANNEL_89                  (TMR_CHANNEL_8)
+
 #define TMR_TCKPS_MASK                  (0x07)
 
 /*FLAGS*/
@@ -29,6 +35,7 @@
 #define TMR_PRESCALER_64                (0x0006)
 #define TMR_PRESCALER_256               (0x0007)
 #define TMR_GATED                       (0x0008)
+/*Counts edges on the TxCK pin, set the period in ticks. These timers stop in Sleep even when clocked externally*/
 #define TMR_EXTERNAL_SOURCE             (0x0010)
 #define TMR_MODE_32                     (0x0020)
 /**********************************************************************
@@ -36,6 +43,15 @@
 **********************************************************************/
 #if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
 
+typedef void (*TMR_Callback)(uint32_t channel, uintptr_t context);
+
+typedef struct{
+    uint32_t    prescaler;      /*TMR_PRESCALER_x*/
+    uint32_t    period;         /*PR value*/
+    uint32_t    frequency;      /*Achieved frequency in Hz*/
+    int32_t     errorPpm;       /*Achieved period error, positive when longer than requested*/
+}TMR_Solution;
+
 /**********************************************************************
 * Function Prototypes
 **********************************************************************/
@@ -44,15 +60,27 @@ extern "C"{
 #endif
 
 void        TMR_initialize(uint32_t channel, uint32_t flags, uint32_t period);
+void        TMR_deinitialize(uint32_t channel);
 void        TMR_start(uint32_t channel);
 void        TMR_stop(uint32_t channel);
-void        TMR_period_set(uint32_t channel, uint16_t period);
+void        TMR_period_set(uint32_t channel, uint32_t period);
+void        TMR_period_load(uint32_t channel, uint32_t period);
 void        TMR_prescaler_set(uint32_t channel, uint16_t prescaler);
 uint32_t    TMR_count_get(uint32_t channel);
+uint32_t    TMR_period_get(uint32_t channel);
 uint32_t    TMR_frequency_get(uint32_t channel);
-void        TMR_frequency_set(uint32_t channel, uint32_t frequency);
+uint32_t    TMR_tick_frequency_get(uint32_t channel);
+uint32_t    TMR_frequency_set(uint32_t channel, uint32_t frequency);
+uint32_t    TMR_period_ns_set(uint32_t channel, uint64_t periodNs);
+bool        TMR_frequency_solve(uint32_t channel, uint32_t frequency, TMR_Solution *solution);
+bool        TMR_period_ns_solve(uint32_t channel, uint64_t periodNs, TMR_Solution *solution);
+void        TMR_solution_apply(uint32_t channel, const TMR_Solution *solution);
 void        TMR_interrupt_handler(uint32_t channel);
 void        TMR_channel_interrupt_callback(uint32_t channel);
+void        TMR_callback_register(uint32_t channel, TMR_Callback callback, uintptr_t context);
+void        TMR_interrupt_set(uint32_t channel, bool state);
+uint32_t    TMR_irq_channel_get(uint32_t channel);
+bool        TMR_is_32bit(uint32_t channel);
 
 #ifdef __cplusplus
 }
@@ -74,6 +74,8 @@ extern "C"{
 #endif
 
 int         UART_initialize(UART_Channel channel, UART_Flags flags, int baudrate, uint8_t *rxBuffer, size_t bufferSize);
+void        UART_deinitialize(UART_Channel channel);
+void        UART_wake_enable(UART_Channel channel, bool enable);
 int         UART_setup(UART_Channel channel, UART_Flags flags, int baudrate);
 size_t      UART_write(UART_Channel channel, uint8_t *txBuffer, size_t size);
 
@@ -87,6 +89,11 @@ bool        UART_tx_ready(UART_Channel channel);
 UART_ERROR  UART_error_get(UART_Channel channel);
 void    UART_callback_register(UART_Channel channel, UART_Callback callback, uintptr_t context);
 
+void        UART_rx_interrupt_handler(UART_Channel channel);
+void        UART_fault_interrupt_handler(UART_Channel channel);
+/*Services every pending source, for parts where RX, TX and fault share one vector*/
+void        UART_interrupt_handler(UART_Channel channel);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,64 @@
+/**
+ * @file waveform.h
+ * @brief DMA driven GPIO waveform generator. A buffer of port words is copied by DMA into the LAT register
+ * (or its CLR/SET/INV shadows) of a port on every period of a timer, word i is output at the end of period i+1.
+ * On the PIC32MZ the word buffer must be placed in coherent (uncached) memory.
+ */
+
+#ifndef WAVEFORM_H
+#define WAVEFORM_H
+
+/**********************************************************************
+* Includes
+**********************************************************************/
+#include "hal_defs.h"
+#include "gpio.h"
+#include "dma.h"
+/**********************************************************************
+* Preprocessor Constants
+**********************************************************************/
+#define WAVE_TARGET_LAT                     (0x0000)
+#define WAVE_TARGET_CLR                     (0x0001)
+#define WAVE_TARGET_SET                     (0x0002)
+#define WAVE_TARGET_INV                     (0x0003)
+#define WAVE_TARGET_MASK                    (0x0003)
+#define WAVE_REPEAT                         (0x0004)
+
+/*WS2812 bit slots, three words per data bit*/
+#define WAVE_WS2812_FREQUENCY               (2400000)
+#define WAVE_WS2812_WORDS_PER_BYTE          (24)
+/*Parallel bus, two words per data byte*/
+#define WAVE_PARALLEL_WORDS_PER_BYTE        (2)
+/**********************************************************************
+* Typedefs
+**********************************************************************/
+#if defined (__LANGUAGE_C__) || defined (__LANGUAGE_C_PLUS_PLUS)
+
+typedef void (*WAVE_Callback)(DMA_Channel channel, uintptr_t context);
+
+/**********************************************************************
+* Function Prototypes
+**********************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+int         WAVE_initialize             (DMA_Channel dmaChannel, uint32_t tmrChannel, GPIO_Port port, uint32_t flags, uint32_t frequency);
+bool        WAVE_start                  (DMA_Channel dmaChannel, const uint16_t *words, size_t count);
+void        WAVE_stop                   (DMA_Channel dmaChannel);
+bool        WAVE_is_busy                (DMA_Channel dmaChannel);
+void        WAVE_callback_register      (DMA_Channel dmaChannel, WAVE_Callback callback, uintptr_t context);
+
+size_t      WAVE_ws2812_encode          (uint16_t *words, size_t size, const uint8_t *data, size_t length, uint16_t pinMask);
+size_t      WAVE_ws2812_encode_lanes    (uint16_t *words, size_t size, const uint8_t * const *lanes, const uint16_t *pinMasks,
+                                         size_t laneCount, size_t length);
+size_t      WAVE_parallel_encode        (uint16_t *words, size_t size, const uint8_t *data, size_t length,
+                                         uint32_t dataShift, uint16_t strobeMask, bool strobeActiveLow);
+void        WAVE_levels_to_toggles      (uint16_t *words, size_t count, uint16_t initial);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif //WAVEFORM_H